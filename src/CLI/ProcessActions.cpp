@@ -351,6 +351,8 @@ bool process_actions(Data& cli, const DynamicPrintConfig& print_config, std::vec
 
             Print       fff_print;
             SLAPrint    sla_print;
+            fff_print.enable_gcode_streaming(cli.misc_config.has("gcode_streaming") && cli.misc_config.opt_bool("gcode_streaming"));
+            fff_print.enable_gcode_single_pass(cli.misc_config.has("gcode_single_pass") && cli.misc_config.opt_bool("gcode_single_pass"));
             sla_print.set_status_callback( [](const PrintBase::SlicingStatus& s) {
                 if (s.percent >= 0) { // FIXME: is this sufficient?
                     printf("%3d%s %s\n", s.percent, "% =>", s.text.c_str());
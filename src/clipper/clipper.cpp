@@ -767,15 +767,25 @@ bool ClipperBase::AddPath(const Path &pg, PolyType PolyTyp, bool Closed)
     return false;
 
   // Allocate a new edge array.
-  Edges edges(highI + 1);
+  Edges &edges = AllocateEdges(highI + 1);
   // Fill in the edge array.
   bool result = AddPathInternal(pg, highI, PolyTyp, Closed, edges.data());
-  if (result)
-    // Success, remember the edge array.
-    m_edges.emplace_back(std::move(edges));
+  if (! result)
+    // Failure, return the edge array.
+    -- m_edgesUsed;
   return result;
 }
 
+ClipperBase::Edges& ClipperBase::AllocateEdges(size_t num_edges)
+{
+  if (m_edgesUsed == m_edges.size())
+    m_edges.emplace_back();
+  Edges &edges = m_edges[m_edgesUsed ++];
+  edges.clear();
+  edges.resize(num_edges);
+  return edges;
+}
+
 bool ClipperBase::AddPathInternal(const Path &pg, int highI, PolyType PolyTyp, bool Closed, TEdge* edges)
 {
 #ifdef use_lines
@@ -959,7 +969,7 @@ bool ClipperBase::AddPathInternal(const Path &pg, int highI, PolyType PolyTyp, b
 void ClipperBase::Clear()
 {
   m_MinimaList.clear();
-  m_edges.clear();
+  m_edgesUsed = 0;
 #ifndef CLIPPERLIB_INT32
   m_UseFullRange = false;
 #endif // CLIPPERLIB_INT32
@@ -967,6 +977,14 @@ void ClipperBase::Clear()
 }
 //------------------------------------------------------------------------------
 
+void ClipperBase::Release()
+{
+  Clear();
+  m_MinimaList = {};
+  m_edges = {};
+}
+//------------------------------------------------------------------------------
+
 // Initialize the Local Minima List:
 // Sort the LML entries, initialize the left / right bound edges of each Local Minima.
 void ClipperBase::Reset()
@@ -1041,6 +1059,7 @@ IntRect ClipperBase::GetBounds()
 
 Clipper::Clipper(int initOptions) : 
   ClipperBase(),
+  m_OutPtsChunksUsed(0),
   m_OutPtsFree(nullptr),
   m_OutPtsChunkLast(m_OutPtsChunkSize),
   m_ActiveEdges(nullptr),
@@ -1059,7 +1078,7 @@ Clipper::Clipper(int initOptions) :
 void Clipper::Reset()
 {
   ClipperBase::Reset();
-  m_Scanbeam = std::priority_queue<cInt, cInts>{};
+  m_Scanbeam.clear();
   m_Maxima.clear();
   m_ActiveEdges = 0;
   m_SortedEdges = 0;
@@ -1174,23 +1193,48 @@ OutPt* Clipper::AllocateOutPt()
     m_OutPtsFree = pt->Next;
   } else if (m_OutPtsChunkLast < m_OutPtsChunkSize) {
     // Get a point from the last chunk.
-    pt = &m_OutPts.back()[m_OutPtsChunkLast ++];
+    pt = &m_OutPts[m_OutPtsChunksUsed - 1][m_OutPtsChunkLast ++];
   } else {
-    // The last chunk is full. Allocate a new one.
-    m_OutPts.emplace_back();
+    // The last chunk is full. Reuse a retained chunk or allocate a new one.
+    if (m_OutPtsChunksUsed == m_OutPts.size())
+      m_OutPts.emplace_back();
     m_OutPtsChunkLast = 1;
-    pt = &m_OutPts.back().front();
+    pt = &m_OutPts[m_OutPtsChunksUsed ++].front();
   }
   return pt;
 }
 
 void Clipper::DisposeAllOutRecs()
 {
-  m_OutPts.clear();
+  m_OutPtsChunksUsed = 0;
   m_OutPtsFree = nullptr;
   m_OutPtsChunkLast = m_OutPtsChunkSize;
   m_PolyOuts.clear();
 }
+
+void Clipper::Release()
+{
+  Clear();
+  ClipperBase::Release();
+  m_OutPts = {};
+  m_PolyOuts = {};
+  m_Joins = {};
+  m_GhostJoins = {};
+  m_IntersectList = {};
+  m_Scanbeam = {};
+  m_Maxima = {};
+}
+
+size_t Clipper::MemoryRetained() const
+{
+  size_t out = m_MinimaList.capacity() * sizeof(LocalMinimum) + m_edges.capacity() * sizeof(Edges) +
+    m_OutPts.size() * sizeof(OutPt) * m_OutPtsChunkSize +
+    (m_Joins.capacity() + m_GhostJoins.capacity()) * sizeof(Join) + m_IntersectList.capacity() * sizeof(IntersectNode) +
+    (m_Scanbeam.capacity() + m_Maxima.capacity()) * sizeof(cInt);
+  for (const Edges &edges : m_edges)
+    out += edges.capacity() * sizeof(TEdge);
+  return out;
+}
 //------------------------------------------------------------------------------
 
 void Clipper::SetWindingCount(TEdge &edge) const
@@ -3368,6 +3412,14 @@ void ClipperOffset::Clear()
 }
 //------------------------------------------------------------------------------
 
+void ClipperOffset::Release()
+{
+  Clear();
+  m_destPolys = {};
+  m_clipper.Release();
+}
+//------------------------------------------------------------------------------
+
 void ClipperOffset::AddPath(const Path& path, JoinType joinType, EndType endType)
 {
   int highI = (int)path.size() - 1;
@@ -3465,7 +3517,9 @@ void ClipperOffset::Execute(Paths& solution, double delta)
   DoOffset(delta);
   
   //now clean up 'corners' ...
-  Clipper clpr;
+  Clipper &clpr = m_clipper;
+  clpr.Clear();
+  clpr.ReverseSolution(false);
   clpr.AddPaths(m_destPolys, ptSubject, true);
   if (delta > 0)
   {
@@ -3486,6 +3540,7 @@ void ClipperOffset::Execute(Paths& solution, double delta)
     if (! solution.empty())
       solution.erase(solution.begin());
   }
+  clpr.Clear();
 }
 //------------------------------------------------------------------------------
 
@@ -3496,7 +3551,9 @@ void ClipperOffset::Execute(PolyTree& solution, double delta)
   DoOffset(delta);
 
   //now clean up 'corners' ...
-  Clipper clpr;
+  Clipper &clpr = m_clipper;
+  clpr.Clear();
+  clpr.ReverseSolution(false);
   clpr.AddPaths(m_destPolys, ptSubject, true);
   if (delta > 0)
   {
@@ -3517,6 +3574,7 @@ void ClipperOffset::Execute(PolyTree& solution, double delta)
     //remove the outer PolyNode rectangle ...
     solution.RemoveOutermostPolygon();
   }
+  clpr.Clear();
 }
 //------------------------------------------------------------------------------
 
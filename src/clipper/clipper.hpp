@@ -358,7 +358,7 @@ public:
       return false;
 
     // Allocate a new edge array.
-    std::vector<TEdge, Allocator<TEdge>> edges(num_edges_total);
+    Edges &edges = AllocateEdges(num_edges_total);
     // Fill in the edge array.
     bool result = false;
     TEdge *p_edge = edges.data();
@@ -373,13 +373,16 @@ public:
       }
       ++ i;
     }
-    if (result)
-      // At least some edges were generated. Remember the edge array.
-      m_edges.emplace_back(std::move(edges));
+    if (! result)
+      // No edges were generated. Return the edge array.
+      -- m_edgesUsed;
     return result;
   }
 
+  // Clear the input paths. The memory allocated by the edge arrays is retained to be reused by the following AddPath() / AddPaths() calls.
   void Clear();
+  // Release all memory allocated.
+  void Release();
   IntRect GetBounds();
   // By default, when three or more vertices are collinear in input polygons (subject or clip), the Clipper object removes the 'inner' vertices before clipping.
   // When enabled the PreserveCollinear property prevents this default behavior to allow these inner vertices to appear in the solution.
@@ -404,9 +407,12 @@ protected:
   bool              m_UseFullRange;
 #endif // CLIPPERLIB_INT32
 
-  // A vector of edges per each input path.
+  // A vector of edges per each input path. Only the first m_edgesUsed are used, the rest is retained after Clear() to be reused.
   using Edges = std::vector<TEdge, Allocator<TEdge>>;
   std::vector<Edges, Allocator<Edges>> m_edges;
+  size_t           m_edgesUsed { 0 };
+  // Take an unused edge array from m_edges, resize it to num_edges and value initialize the edges.
+  Edges& AllocateEdges(size_t num_edges);
   // Don't remove intermediate vertices of a collinear sequence of points.
   bool             m_PreserveCollinear;
   // Is any of the paths inserted by AddPath() or AddPaths() open?
@@ -419,7 +425,12 @@ class Clipper : public ClipperBase
 public:
   Clipper(int initOptions = 0);
   ~Clipper() { Clear(); }
+  // Clear the input paths and the output polygons. The memory allocated is retained to be reused by the following operation.
   void Clear() { ClipperBase::Clear(); DisposeAllOutRecs(); }
+  // Release all memory allocated.
+  void Release();
+  // Memory allocated by the internal buffers, which would be reused by the following operations.
+  size_t MemoryRetained() const;
   bool Execute(ClipType clipType,
       Paths &solution,
       PolyFillType fillType = pftEvenOdd) 
@@ -452,8 +463,10 @@ private:
   // Output polygons.
   std::deque<OutRec, Allocator<OutRec>>  m_PolyOuts;
   // Output points, allocated by a continuous sets of m_OutPtsChunkSize.
+  // Only the first m_OutPtsChunksUsed chunks are used, the rest is retained after DisposeAllOutRecs() to be reused.
   static constexpr const size_t m_OutPtsChunkSize = 32;
   std::deque<std::array<OutPt, m_OutPtsChunkSize>, Allocator<std::array<OutPt, m_OutPtsChunkSize>>> m_OutPts;
+  size_t                m_OutPtsChunksUsed;
   // List of free output points, to be used before taking a point from m_OutPts or allocating a new chunk.
   OutPt                *m_OutPtsFree;
   size_t                m_OutPtsChunkLast;
@@ -464,7 +477,12 @@ private:
   ClipType              m_ClipType;
   // A priority queue (a binary heap) of Y coordinates.
   using cInts = std::vector<cInt, Allocator<cInt>>;
-  std::priority_queue<cInt, cInts> m_Scanbeam;
+  struct Scanbeam : public std::priority_queue<cInt, cInts> {
+    // Unlike assigning an empty priority_queue, clear() retains the memory of the underlying container.
+    void clear() { this->c.clear(); }
+    size_t capacity() const { return this->c.capacity(); }
+  };
+  Scanbeam              m_Scanbeam;
   // Maxima are collected by ProcessEdgesAtTopOfScanbeam(), consumed by ProcessHorizontal().
   cInts                 m_Maxima;
   TEdge                *m_ActiveEdges;
@@ -550,6 +568,10 @@ public:
   void Execute(Paths& solution, double delta);
   void Execute(PolyTree& solution, double delta);
   void Clear();
+  // Release the memory retained by the Clipper engine cleaning up the offset.
+  void Release();
+  // Memory allocated by the Clipper engine cleaning up the offset, which would be reused by the following Execute().
+  size_t MemoryRetained() const { return m_clipper.MemoryRetained(); }
   double MiterLimit;
   double ArcTolerance;
   double ShortestEdgeLength;
@@ -565,6 +587,8 @@ private:
   // y: index of the lowest point in the lowest contour
   IntPoint m_lowest;
   PolyNode m_polyNodes;
+  // Cleans up the offset, its memory is retained after Execute() to be reused.
+  Clipper m_clipper;
 
   void FixOrientations();
   void DoOffset(double delta);
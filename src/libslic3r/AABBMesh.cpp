@@ -4,7 +4,7 @@
 ///|/
 #include "AABBMesh.hpp"
 
-#include <libslic3r/AABBTreeIndirect.hpp>
+#include <libslic3r/AABBTreeWide.hpp>
 #include <libslic3r/TriangleMesh.hpp>
 #include <igl/Hit.h>
 #include <algorithm>
@@ -20,7 +20,7 @@ namespace Slic3r {
 
 class AABBMesh::AABBImpl {
 private:
-    AABBTreeIndirect::Tree3f m_tree;
+    AABBTreeIndirect::WideTree4f m_tree;
     double                   m_triangle_ray_epsilon;
 
 public:
@@ -33,7 +33,7 @@ public:
             if (l > 0)
                 m_triangle_ray_epsilon = 0.000001 * l * l;
         }
-        m_tree = AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(
+        m_tree = AABBTreeIndirect::build_wide_aabb_tree_over_indexed_triangle_set<4>(
             its.vertices, its.indices);
     }
 
@@ -668,12 +668,12 @@ namespace detail {
 
 } // namespace detail
 
-// Build a balanced AABB Tree over an indexed triangles set, balancing the tree
-// on centroids of the triangles.
+// Build an AABB Tree of TreeType (AABBTreeIndirect::Tree or AABBTreeIndirect::WideTree) over an indexed triangles set,
+// balancing the tree on centroids of the triangles.
 // Epsilon is applied to the bounding boxes of the AABB Tree to cope with numeric inaccuracies
 // during tree traversal.
-template<typename VertexType, typename IndexedFaceType>
-inline Tree<3, typename VertexType::Scalar> build_aabb_tree_over_indexed_triangle_set(
+template<typename TreeType, typename VertexType, typename IndexedFaceType>
+inline TreeType build_aabb_tree_over_indexed_triangle_set(
 	// Indexed triangle set - 3D vertices.
 	const std::vector<VertexType> 		&vertices, 
 	// Indexed triangle set - triangular faces, references to vertices.
@@ -681,8 +681,6 @@ inline Tree<3, typename VertexType::Scalar> build_aabb_tree_over_indexed_triangl
 	//FIXME do we want to apply an epsilon?
     const typename VertexType::Scalar 	 eps = 0)
 {
-    using 				 TreeType 		= Tree<3, typename VertexType::Scalar>;
-//    using				 CoordType      = typename TreeType::CoordType;
     using 				 VectorType	    = typename TreeType::VectorType;
     using 				 BoundingBox 	= typename TreeType::BoundingBox;
 
@@ -720,9 +718,25 @@ inline Tree<3, typename VertexType::Scalar> build_aabb_tree_over_indexed_triangl
 	return out;
 }
 
+// Build a balanced AABB Tree over an indexed triangles set, balancing the tree
+// on centroids of the triangles.
+template<typename VertexType, typename IndexedFaceType>
+inline Tree<3, typename VertexType::Scalar> build_aabb_tree_over_indexed_triangle_set(
+	// Indexed triangle set - 3D vertices.
+	const std::vector<VertexType> 		&vertices, 
+	// Indexed triangle set - triangular faces, references to vertices.
+    const std::vector<IndexedFaceType> 	&faces,
+	//FIXME do we want to apply an epsilon?
+    const typename VertexType::Scalar 	 eps = 0)
+{
+	return build_aabb_tree_over_indexed_triangle_set<Tree<3, typename VertexType::Scalar>>(vertices, faces, eps);
+}
+
 // Find a first intersection of a ray with indexed triangle set.
 // Intersection test is calculated with the accuracy of VectorType::Scalar
 // even if the triangle mesh and the AABB Tree are built with floats.
+// Rays are traced one by one. Tracing packets of coherent rays with a shared traversal stack was
+// measured slower, as the rays of a packet diverge after a few levels of the tree.
 template<typename VertexType, typename IndexedFaceType, typename TreeType, typename VectorType>
 inline bool intersect_ray_first_hit(
 	// Indexed triangle set - 3D vertices.
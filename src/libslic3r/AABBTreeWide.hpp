@@ -0,0 +1,568 @@
+// Wide AABB tree built upon external data set, referencing the external data by integer indices.
+// An alternative to the balanced binary AABBTreeIndirect::Tree for meshes with uneven triangle density:
+// The tree is built using the surface area heuristic (SAH) and each of its nodes stores bounding boxes
+// of up to 4 or 8 children in a structure of arrays layout, so that the children are tested in a single loop,
+// which the compiler vectorizes.
+// The tree is queried through the same free functions as AABBTreeIndirect::Tree, the overloads
+// for WideTree are declared here.
+
+#ifndef slic3r_AABBTreeWide_hpp_
+#define slic3r_AABBTreeWide_hpp_
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <oneapi/tbb/parallel_for.h>
+
+#include "AABBTreeIndirect.hpp"
+
+namespace Slic3r {
+namespace AABBTreeIndirect {
+
+template<int AWidth, typename ACoordType>
+class WideTree
+{
+public:
+    static constexpr int    Width         = AWidth;
+    static constexpr int    NumDimensions = 3;
+    using                   CoordType     = ACoordType;
+    using                   VectorType    = Eigen::Matrix<CoordType, NumDimensions, 1, Eigen::DontAlign>;
+    using                   BoundingBox   = Eigen::AlignedBox<CoordType, NumDimensions>;
+    static_assert(Width == 4 || Width == 8, "WideTree supports 4 or 8 children per node only.");
+
+    // Maximum number of entities referenced by a single leaf.
+    static constexpr size_t MaxLeafSize   = 4;
+    // Number of levels built with the surface area heuristic. Deeper subtrees are split by median,
+    // which limits depth of the tree and thus the size of the traversal stack.
+    static constexpr int    MaxSAHDepth   = 32;
+    // Each level of the tree halves the number of entities below MaxSAHDepth, leaving at most 32 more levels
+    // for 32bit entity indices. A traversal pushes at most Width - 1 children per level to the stack.
+    static constexpr size_t MaxStackSize  = size_t(MaxSAHDepth + 34) * Width;
+
+    // Node of the tree storing bounding boxes of up to Width children in a structure of arrays layout.
+    struct Node {
+        std::array<CoordType, Width>    min_x, min_y, min_z;
+        std::array<CoordType, Width>    max_x, max_y, max_z;
+        // Index of a child node for inner children, index of the first entity in entities() for leaf children.
+        std::array<uint32_t, Width>     child;
+        // Number of entities referenced by a leaf child, zero for an inner child.
+        std::array<uint32_t, Width>     num_entities;
+        // Number of valid children, the children are stored first. Bounding boxes of the unused slots are zero.
+        uint32_t                        num_children { 0 };
+
+        bool        is_leaf(int i) const { return num_entities[i] > 0; }
+        BoundingBox bbox(int i) const { return BoundingBox(VectorType(min_x[i], min_y[i], min_z[i]), VectorType(max_x[i], max_y[i], max_z[i])); }
+    };
+
+    void clear() { m_nodes.clear(); m_entities.clear(); m_bbox.setEmpty(); }
+
+    // SourceNode shall implement the same interface as for AABBTreeIndirect::Tree::build():
+    // size_t SourceNode::idx() const, const VectorType& SourceNode::centroid() const, const BoundingBox& SourceNode::bbox() const
+    // The subtrees of large nodes are built in parallel.
+    template<typename SourceNode>
+    void build(std::vector<SourceNode> &&input)
+    {
+        this->clear();
+        if (input.empty())
+            return;
+        assert(input.size() < size_t(std::numeric_limits<uint32_t>::max()));
+        const Range root = bounds(input, 0, input.size());
+        m_bbox = root.bbox;
+        build_recursive(input, root, 0, m_nodes);
+        m_entities.reserve(input.size());
+        for (const SourceNode &n : input)
+            m_entities.emplace_back(n.idx());
+        input.clear();
+    }
+
+    template<typename SourceNode>
+    void build(const std::vector<SourceNode> &input)
+    {
+        std::vector<SourceNode> copy(input);
+        this->build(std::move(copy));
+    }
+
+    const std::vector<Node>&    nodes() const { return m_nodes; }
+    const Node&                 node(size_t idx) const { return m_nodes[idx]; }
+    // Indices of the external entities referenced by the leaves.
+    const std::vector<size_t>&  entities() const { return m_entities; }
+    // Bounding box of the whole tree.
+    const BoundingBox&          bbox() const { return m_bbox; }
+    bool                        empty() const { return m_nodes.empty(); }
+
+private:
+    // Span of the input entities with their bounding box and the bounding box of their centroids.
+    struct Range {
+        size_t      begin;
+        size_t      end;
+        BoundingBox bbox;
+        BoundingBox centroid_bbox;
+        // The range was decided to be stored as a leaf.
+        bool        leaf { false };
+
+        size_t      size() const { return end - begin; }
+    };
+
+    // Number of bins of the binned SAH build.
+    static constexpr int    NumBins             = 16;
+    // Cost of traversing a node relative to the cost of testing a single entity.
+    static constexpr double TraversalCost       = 1.;
+    // Subtrees over more entities than this threshold are built in parallel.
+    static constexpr size_t ParallelThreshold   = 4096;
+
+    static double half_area(const BoundingBox &bbox)
+    {
+        const Eigen::Matrix<double, 3, 1, Eigen::DontAlign> d = bbox.sizes().template cast<double>();
+        return d.x() * d.y() + d.y() * d.z() + d.z() * d.x();
+    }
+
+    template<typename SourceNode>
+    static Range bounds(const std::vector<SourceNode> &input, size_t begin, size_t end)
+    {
+        Range out;
+        out.begin = begin;
+        out.end   = end;
+        out.bbox.setEmpty();
+        out.centroid_bbox.setEmpty();
+        for (size_t i = begin; i < end; ++ i) {
+            out.bbox.extend(input[i].bbox());
+            out.centroid_bbox.extend(input[i].centroid());
+        }
+        return out;
+    }
+
+    // Split the range into two by the surface area heuristic evaluated over NumBins bins of centroids along each axis,
+    // or by median if sah is false. Returns false if the range shall be stored as a leaf.
+    // The range is passed by value, as it may be overwritten by left.
+    template<typename SourceNode>
+    static bool split(std::vector<SourceNode> &input, const Range range, bool sah, Range &left, Range &right)
+    {
+        const size_t n = range.size();
+        if (n <= 1)
+            return false;
+        const VectorType extent = range.centroid_bbox.sizes();
+        int              dimension;
+        if (extent.maxCoeff(&dimension) <= 0) {
+            // All the centroids are the same, split in the middle.
+            if (n <= MaxLeafSize)
+                return false;
+            left  = bounds(input, range.begin, range.begin + n / 2);
+            right = bounds(input, range.begin + n / 2, range.end);
+            return true;
+        }
+
+        size_t center = range.begin + n / 2;
+        if (sah) {
+            struct Bin {
+                BoundingBox bbox;
+                size_t      count { 0 };
+            };
+            // Bin the entities along all the three axes in a single pass. Centroids along an axis of zero extent
+            // all fall into the first bin, thus no split is found along such an axis.
+            const Eigen::Matrix<double, 3, 1, Eigen::DontAlign> min   = range.centroid_bbox.min().template cast<double>();
+            const Eigen::Matrix<double, 3, 1, Eigen::DontAlign> scale = extent.template cast<double>().unaryExpr(
+                [](double e) { return e > 0. ? NumBins / e : 0.; });
+            auto bin_idx = [&min, &scale](const auto &centroid, int axis) {
+                return std::min(int((centroid(axis) - min(axis)) * scale(axis)), NumBins - 1);
+            };
+            std::array<std::array<Bin, NumBins>, 3> bins;
+            for (std::array<Bin, NumBins> &axis_bins : bins)
+                for (Bin &bin : axis_bins)
+                    bin.bbox.setEmpty();
+            for (size_t i = range.begin; i < range.end; ++ i)
+                for (int axis = 0; axis < 3; ++ axis) {
+                    Bin &bin = bins[axis][bin_idx(input[i].centroid(), axis)];
+                    bin.bbox.extend(input[i].bbox());
+                    ++ bin.count;
+                }
+            double best_cost  = std::numeric_limits<double>::max();
+            int    best_axis  = -1;
+            int    best_split = 0;
+            for (int axis = 0; axis < 3; ++ axis) {
+                // Sweep from the right to accumulate cost of the right sides, then from the left.
+                std::array<double, NumBins> right_cost;
+                BoundingBox bbox;
+                bbox.setEmpty();
+                size_t count = 0;
+                for (int i = NumBins - 1; i > 0; -- i) {
+                    bbox.extend(bins[axis][i].bbox);
+                    count += bins[axis][i].count;
+                    right_cost[i] = count == 0 ? -1. : half_area(bbox) * double(count);
+                }
+                bbox.setEmpty();
+                count = 0;
+                for (int i = 1; i < NumBins; ++ i) {
+                    bbox.extend(bins[axis][i - 1].bbox);
+                    count += bins[axis][i - 1].count;
+                    if (count == 0 || right_cost[i] < 0.)
+                        continue;
+                    if (double cost = half_area(bbox) * double(count) + right_cost[i]; cost < best_cost) {
+                        best_cost  = cost;
+                        best_axis  = axis;
+                        best_split = i;
+                    }
+                }
+            }
+            assert(best_axis != -1);
+            const double area = half_area(range.bbox);
+            if (n <= MaxLeafSize && double(n) * area <= TraversalCost * area + best_cost)
+                // Testing all the entities is cheaper than traversing one more level of the tree.
+                return false;
+            center = size_t(std::partition(input.begin() + range.begin, input.begin() + range.end,
+                [&bin_idx, best_axis, best_split](const SourceNode &node) { return bin_idx(node.centroid(), best_axis) < best_split; }) - input.begin());
+        } else {
+            if (n <= MaxLeafSize)
+                return false;
+            std::nth_element(input.begin() + range.begin, input.begin() + center, input.begin() + range.end,
+                [dimension](const SourceNode &l, const SourceNode &r) { return l.centroid()(dimension) < r.centroid()(dimension); });
+        }
+        assert(center > range.begin && center < range.end);
+        left  = bounds(input, range.begin, center);
+        right = bounds(input, center, range.end);
+        return true;
+    }
+
+    // Build a subtree over a range of the input, appending its nodes to "nodes", the root of the subtree first.
+    // Indices of the child nodes are relative to the beginning of "nodes".
+    template<typename SourceNode>
+    static void build_recursive(std::vector<SourceNode> &input, const Range &range, int depth, std::vector<Node> &nodes)
+    {
+        const bool sah = depth < MaxSAHDepth;
+        // Collapse the binary splits into up to Width children by repeatedly splitting the child with the largest surface area.
+        std::array<Range, Width> children;
+        int                      num_children = 1;
+        children.front() = range;
+        while (num_children < Width) {
+            int    best      = -1;
+            double best_area = -1.;
+            for (int i = 0; i < num_children; ++ i)
+                if (! children[i].leaf)
+                    if (double area = half_area(children[i].bbox); area > best_area) {
+                        best      = i;
+                        best_area = area;
+                    }
+            if (best == -1)
+                break;
+            if (! split(input, children[best], sah, children[best], children[num_children]))
+                children[best].leaf = true;
+            else
+                ++ num_children;
+        }
+        // Small children, which were not split yet, may become leaves.
+        for (int i = 0; i < num_children; ++ i)
+            if (Range &child = children[i]; ! child.leaf && child.size() <= MaxLeafSize) {
+                Range left, right;
+                child.leaf = ! split(input, child, sah, left, right);
+            }
+
+        const size_t node_idx = nodes.size();
+        {
+            Node &node = nodes.emplace_back();
+            node.num_children = uint32_t(num_children);
+            for (int i = 0; i < Width; ++ i) {
+                BoundingBox bbox(VectorType::Zero(), VectorType::Zero());
+                node.child[i]        = 0;
+                node.num_entities[i] = 0;
+                if (i < num_children) {
+                    bbox = children[i].bbox;
+                    if (children[i].leaf) {
+                        node.child[i]        = uint32_t(children[i].begin);
+                        node.num_entities[i] = uint32_t(children[i].size());
+                    }
+                }
+                node.min_x[i] = bbox.min().x(); node.min_y[i] = bbox.min().y(); node.min_z[i] = bbox.min().z();
+                node.max_x[i] = bbox.max().x(); node.max_y[i] = bbox.max().y(); node.max_z[i] = bbox.max().z();
+            }
+        }
+
+        std::array<int, Width> inner;
+        int                    num_inner = 0;
+        for (int i = 0; i < num_children; ++ i)
+            if (! children[i].leaf)
+                inner[num_inner ++] = i;
+        if (range.size() > ParallelThreshold && num_inner > 1) {
+            // Build the subtrees in parallel, then append them while relocating their child node indices.
+            std::array<std::vector<Node>, Width> subtrees;
+            tbb::parallel_for(0, num_inner, [&input, &children, &inner, &subtrees, depth](int i) {
+                build_recursive(input, children[inner[i]], depth + 1, subtrees[i]);
+            });
+            for (int i = 0; i < num_inner; ++ i) {
+                const uint32_t offset = uint32_t(nodes.size());
+                nodes[node_idx].child[inner[i]] = offset;
+                for (Node &node : subtrees[i]) {
+                    for (uint32_t j = 0; j < node.num_children; ++ j)
+                        if (! node.is_leaf(int(j)))
+                            node.child[j] += offset;
+                    nodes.emplace_back(node);
+                }
+            }
+        } else {
+            for (int i = 0; i < num_inner; ++ i) {
+                nodes[node_idx].child[inner[i]] = uint32_t(nodes.size());
+                build_recursive(input, children[inner[i]], depth + 1, nodes);
+            }
+        }
+    }
+
+    std::vector<Node>       m_nodes;
+    std::vector<size_t>     m_entities;
+    BoundingBox             m_bbox;
+};
+
+using WideTree4f = WideTree<4, float>;
+using WideTree8f = WideTree<8, float>;
+using WideTree4d = WideTree<4, double>;
+using WideTree8d = WideTree<8, double>;
+
+namespace detail {
+
+    // Depth first traversal of a WideTree. node_keys(node, keys) returns a bit mask of the children of the node to visit
+    // and fills in their keys (the ray entry parameter, the squared distance etc). Children with keys above limit are skipped,
+    // the others are visited in the order of increasing keys. visit_entity(idx) is called for the entities of the visited leaves,
+    // it may lower the limit to prune the rest of the traversal.
+    template<typename TreeType, typename Scalar, typename NodeKeys, typename EntityVisitor>
+    inline void traverse_wide_tree(const TreeType &tree, NodeKeys &&node_keys, EntityVisitor &&visit_entity, const Scalar &limit)
+    {
+        constexpr int Width = TreeType::Width;
+        struct StackItem {
+            uint32_t child;
+            uint32_t num_entities;
+            Scalar   key;
+        };
+        std::array<StackItem, TreeType::MaxStackSize> stack;
+        size_t stack_size = 0;
+        stack[stack_size ++] = { 0, 0, Scalar(0) };
+        std::array<Scalar, Width> keys;
+        while (stack_size > 0) {
+            const StackItem item = stack[-- stack_size];
+            if (item.key > limit)
+                continue;
+            if (item.num_entities > 0) {
+                for (uint32_t i = item.child; i < item.child + item.num_entities; ++ i)
+                    visit_entity(tree.entities()[i]);
+                continue;
+            }
+            const auto    &node = tree.node(item.child);
+            const unsigned mask = node_keys(node, keys);
+            // Sort the visited children by decreasing keys, so that the closest child will be popped first.
+            std::array<int, Width> order;
+            int                    num_visited = 0;
+            for (int i = 0; i < int(node.num_children); ++ i)
+                if (((mask >> i) & 1) && keys[i] <= limit) {
+                    int j = num_visited ++;
+                    for (; j > 0 && keys[order[j - 1]] < keys[i]; -- j)
+                        order[j] = order[j - 1];
+                    order[j] = i;
+                }
+            assert(stack_size + num_visited <= stack.size());
+            for (int j = 0; j < num_visited; ++ j)
+                stack[stack_size ++] = { node.child[order[j]], node.num_entities[order[j]], keys[order[j]] };
+        }
+    }
+
+    // Slab test of a ray against all children of a WideTree node, returning the bit mask of the intersected children
+    // and the ray parameters of entering their bounding boxes.
+    template<typename Node, typename VectorType, typename Scalar, size_t Width>
+    inline unsigned wide_ray_box_intersect_invdir(const Node &node, const VectorType &origin, const VectorType &invdir, Scalar t_max, std::array<Scalar, Width> &tenter)
+    {
+        unsigned mask = 0;
+        for (size_t i = 0; i < Width; ++ i) {
+            const Scalar tx0   = (Scalar(node.min_x[i]) - origin.x()) * invdir.x();
+            const Scalar tx1   = (Scalar(node.max_x[i]) - origin.x()) * invdir.x();
+            const Scalar ty0   = (Scalar(node.min_y[i]) - origin.y()) * invdir.y();
+            const Scalar ty1   = (Scalar(node.max_y[i]) - origin.y()) * invdir.y();
+            const Scalar tz0   = (Scalar(node.min_z[i]) - origin.z()) * invdir.z();
+            const Scalar tz1   = (Scalar(node.max_z[i]) - origin.z()) * invdir.z();
+            const Scalar tmin  = std::max(std::max(std::min(tx0, tx1), std::min(ty0, ty1)), std::max(std::min(tz0, tz1), Scalar(0)));
+            const Scalar tmax  = std::min(std::min(std::max(tx0, tx1), std::max(ty0, ty1)), std::min(std::max(tz0, tz1), t_max));
+            tenter[i] = tmin;
+            mask |= unsigned(tmin <= tmax) << i;
+        }
+        return mask;
+    }
+
+    // Squared distances of a point to the bounding boxes of all children of a WideTree node.
+    template<typename Node, typename VectorType, typename Scalar, size_t Width>
+    inline unsigned wide_box_squared_distances(const Node &node, const VectorType &point, std::array<Scalar, Width> &squared_distances)
+    {
+        for (size_t i = 0; i < Width; ++ i) {
+            const Scalar dx = std::max(std::max(Scalar(node.min_x[i]) - point.x(), point.x() - Scalar(node.max_x[i])), Scalar(0));
+            const Scalar dy = std::max(std::max(Scalar(node.min_y[i]) - point.y(), point.y() - Scalar(node.max_y[i])), Scalar(0));
+            const Scalar dz = std::max(std::max(Scalar(node.min_z[i]) - point.z(), point.z() - Scalar(node.max_z[i])), Scalar(0));
+            squared_distances[i] = dx * dx + dy * dy + dz * dz;
+        }
+        return (1u << Width) - 1;
+    }
+
+} // namespace detail
+
+// Build an AABB tree over an indexed triangle set using the surface area heuristic.
+// See build_aabb_tree_over_indexed_triangle_set().
+template<int Width, typename VertexType, typename IndexedFaceType>
+inline WideTree<Width, typename VertexType::Scalar> build_wide_aabb_tree_over_indexed_triangle_set(
+    const std::vector<VertexType>       &vertices,
+    const std::vector<IndexedFaceType>  &faces,
+    const typename VertexType::Scalar    eps = 0)
+{
+    return build_aabb_tree_over_indexed_triangle_set<WideTree<Width, typename VertexType::Scalar>>(vertices, faces, eps);
+}
+
+// WideTree variant of intersect_ray_first_hit().
+// The hit closest to the ray origin is returned, if multiple triangles are hit at the same distance
+// (a ray passing through a shared edge), the one with the lowest index is reported, thus the result does not depend
+// on the shape of the tree. AABBTreeIndirect::Tree may report any of these triangles.
+template<typename VertexType, typename IndexedFaceType, int Width, typename CoordType, typename VectorType>
+inline bool intersect_ray_first_hit(
+    const std::vector<VertexType>       &vertices,
+    const std::vector<IndexedFaceType>  &faces,
+    const WideTree<Width, CoordType>    &tree,
+    const VectorType                    &origin,
+    const VectorType                    &dir,
+    igl::Hit                            &hit,
+    const double                         eps = 0.000001)
+{
+    using Scalar = typename VectorType::Scalar;
+    if (tree.empty())
+        return false;
+    const VectorType invdir  = dir.cwiseInverse();
+    Scalar           min_t   = std::numeric_limits<Scalar>::infinity();
+    size_t           min_idx = std::numeric_limits<size_t>::max();
+    // Boxes entered at exactly min_t are still traversed, so that all the triangles hit at min_t are visited.
+    detail::traverse_wide_tree(tree,
+        [&origin, &invdir, &min_t](const auto &node, std::array<Scalar, Width> &keys) {
+            return detail::wide_ray_box_intersect_invdir(node, origin, invdir, min_t, keys);
+        },
+        [&](size_t idx) {
+            const IndexedFaceType &face = faces[idx];
+            double t, u, v;
+            if (detail::intersect_triangle(origin, dir, vertices[face(0)], vertices[face(1)], vertices[face(2)], t, u, v, eps) &&
+                t > 0. && (Scalar(t) < min_t || (Scalar(t) == min_t && idx < min_idx))) {
+                hit     = igl::Hit { int(idx), -1, float(u), float(v), float(t) };
+                min_t   = Scalar(t);
+                min_idx = idx;
+            }
+        }, min_t);
+    return min_idx != std::numeric_limits<size_t>::max();
+}
+
+// WideTree variant of intersect_ray_all_hits().
+template<typename VertexType, typename IndexedFaceType, int Width, typename CoordType, typename VectorType>
+inline bool intersect_ray_all_hits(
+    const std::vector<VertexType>       &vertices,
+    const std::vector<IndexedFaceType>  &faces,
+    const WideTree<Width, CoordType>    &tree,
+    const VectorType                    &origin,
+    const VectorType                    &dir,
+    std::vector<igl::Hit>               &hits,
+    const double                         eps = 0.000001)
+{
+    using Scalar = typename VectorType::Scalar;
+    hits.clear();
+    if (tree.empty())
+        return false;
+    const VectorType invdir = dir.cwiseInverse();
+    const Scalar     max_t  = std::numeric_limits<Scalar>::infinity();
+    detail::traverse_wide_tree(tree,
+        [&origin, &invdir, max_t](const auto &node, std::array<Scalar, Width> &keys) {
+            return detail::wide_ray_box_intersect_invdir(node, origin, invdir, max_t, keys);
+        },
+        [&](size_t idx) {
+            const IndexedFaceType &face = faces[idx];
+            double t, u, v;
+            if (detail::intersect_triangle(origin, dir, vertices[face(0)], vertices[face(1)], vertices[face(2)], t, u, v, eps))
+                hits.push_back(igl::Hit { int(idx), -1, float(u), float(v), float(t) });
+        }, max_t);
+    std::sort(hits.begin(), hits.end(), [](const auto &l, const auto &r) { return l.t < r.t; });
+    return ! hits.empty();
+}
+
+// WideTree variant of squared_distance_to_indexed_triangle_set().
+template<typename VertexType, typename IndexedFaceType, int Width, typename CoordType, typename VectorType>
+inline typename VectorType::Scalar squared_distance_to_indexed_triangle_set(
+    const std::vector<VertexType>       &vertices,
+    const std::vector<IndexedFaceType>  &faces,
+    const WideTree<Width, CoordType>    &tree,
+    const VectorType                    &point,
+    size_t                              &hit_idx_out,
+    Eigen::PlainObjectBase<VectorType>  &hit_point_out,
+    // Only triangles closer than sqrt(max_distance_squared) are considered.
+    typename VectorType::Scalar          max_distance_squared = std::numeric_limits<typename VectorType::Scalar>::infinity())
+{
+    using Scalar = typename VectorType::Scalar;
+    if (tree.empty())
+        return Scalar(-1);
+    Scalar up_sqr_d = max_distance_squared;
+    detail::traverse_wide_tree(tree,
+        [&point](const auto &node, std::array<Scalar, Width> &keys) {
+            return detail::wide_box_squared_distances(node, point, keys);
+        },
+        [&](size_t idx) {
+            const IndexedFaceType &face = faces[idx];
+            const VectorType c = detail::closest_point_to_triangle<VectorType>(point,
+                vertices[face(0)].template cast<Scalar>(), vertices[face(1)].template cast<Scalar>(), vertices[face(2)].template cast<Scalar>());
+            if (Scalar sqr_d = (point - c).squaredNorm(); sqr_d < up_sqr_d) {
+                hit_idx_out   = idx;
+                hit_point_out = c;
+                up_sqr_d      = sqr_d;
+            }
+        }, up_sqr_d);
+    return up_sqr_d;
+}
+
+// WideTree variant of is_any_triangle_in_radius().
+template<typename VertexType, typename IndexedFaceType, int Width, typename CoordType, typename VectorType>
+inline bool is_any_triangle_in_radius(
+    const std::vector<VertexType>       &vertices,
+    const std::vector<IndexedFaceType>  &faces,
+    const WideTree<Width, CoordType>    &tree,
+    const VectorType                    &point,
+    typename VectorType::Scalar         &max_distance_squared)
+{
+    size_t     hit_idx;
+    VectorType hit_point = VectorType::Ones() * (NaN<typename VectorType::Scalar>);
+    if (tree.empty())
+        return false;
+    squared_distance_to_indexed_triangle_set(vertices, faces, tree, point, hit_idx, hit_point, max_distance_squared);
+    return hit_point.allFinite();
+}
+
+// WideTree variant of all_triangles_in_radius().
+template<typename VertexType, typename IndexedFaceType, int Width, typename CoordType, typename VectorType>
+inline std::vector<size_t> all_triangles_in_radius(
+    const std::vector<VertexType>       &vertices,
+    const std::vector<IndexedFaceType>  &faces,
+    const WideTree<Width, CoordType>    &tree,
+    const VectorType                    &point,
+    typename VectorType::Scalar          max_distance_squared)
+{
+    using Scalar = typename VectorType::Scalar;
+    std::vector<size_t> found_triangles;
+    if (tree.empty())
+        return found_triangles;
+    detail::traverse_wide_tree(tree,
+        [&point, max_distance_squared](const auto &node, std::array<Scalar, Width> &keys) {
+            // Children closer than the limit are visited, keys equal to the limit are rejected.
+            unsigned mask = detail::wide_box_squared_distances(node, point, keys);
+            for (int i = 0; i < Width; ++ i)
+                if (keys[i] >= max_distance_squared)
+                    mask &= ~(1u << i);
+            return mask;
+        },
+        [&](size_t idx) {
+            const IndexedFaceType &face = faces[idx];
+            const VectorType c = detail::closest_point_to_triangle<VectorType>(point,
+                vertices[face(0)].template cast<Scalar>(), vertices[face(1)].template cast<Scalar>(), vertices[face(2)].template cast<Scalar>());
+            if ((point - c).squaredNorm() < max_distance_squared)
+                found_triangles.push_back(idx);
+        }, max_distance_squared);
+    return found_triangles;
+}
+
+} // namespace AABBTreeIndirect
+} // namespace Slic3r
+
+#endif // slic3r_AABBTreeWide_hpp_
@@ -221,7 +221,8 @@ static ExPolygons top_level_outer_brim_area(const Print                   &print
         }
     }
 
-    return diff_ex(brim_area, no_brim_area);
+    // Brim areas of distant objects do not interact, they are clipped in parallel.
+    return diff_ex_parallel(brim_area, no_brim_area);
 }
 
 // Return vector of booleans indicated if polygons from bottom_layers_expolygons contain another polygon or not.
@@ -533,7 +534,7 @@ ExtrusionEntityCollection make_brim(const Print &print, PrintTryCancel try_cance
     size_t          num_loops = size_t(floor(max_brim_width(print.objects()) / flow.spacing()));
     for (size_t i = 0; i < num_loops; ++i) {
         try_cancel();
-        islands = expand(islands, float(flow.scaled_spacing()), ClipperLib::jtSquare);
+        islands = expand_parallel(islands, float(flow.scaled_spacing()), ClipperLib::jtSquare);
         for (Polygon &poly : islands) 
             poly.douglas_peucker(scaled_resolution);
         polygons_append(loops, shrink(islands, 0.5f * float(flow.scaled_spacing())));
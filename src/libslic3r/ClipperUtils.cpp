@@ -12,6 +12,7 @@
 #include "ClipperUtils.hpp"
 
 #include <cmath>
+#include <numeric>
 
 #include "ShortestPath.hpp"
 #include "libslic3r/BoundingBox.hpp"
@@ -21,6 +22,7 @@
 #include "libslic3r/libslic3r.h"
 
 #include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
 #include <oneapi/tbb/parallel_reduce.h>
 
 // #define CLIPPER_UTILS_TIMING
@@ -206,9 +208,92 @@ namespace ClipperUtils {
         out.erase(std::remove_if(out.begin(), out.end(), [](const Polygon &polygon) {return polygon.empty(); }), out.end());
         return out;
     }
+
+    // Engine retained by a thread and whether it is currently borrowed by a ThreadLocalEngine.
+    template<typename Engine>
+    struct ThreadEngineSlot
+    {
+        std::unique_ptr<Engine> engine;
+        bool                    borrowed { false };
+    };
+
+    template<typename Engine>
+    static ThreadEngineSlot<Engine>& thread_engine_slot()
+    {
+        static thread_local ThreadEngineSlot<Engine> slot;
+        return slot;
+    }
+
+    // A Clipper engine (or the Clipper engine of ClipperOffset) retaining more memory than this limit releases it when returned,
+    // so that a single huge boolean operation does not keep its memory allocated by a worker thread forever.
+    static constexpr const size_t ClipperEngineMemoryLimit = size_t(16) << 20;
+
+    static void reset_engine_options(ClipperLib::Clipper &clipper)
+    {
+        clipper.ReverseSolution(false);
+        clipper.StrictlySimple(false);
+        clipper.PreserveCollinear(false);
+    }
+
+    static void reset_engine_options(ClipperLib::ClipperOffset &co)
+    {
+        co.MiterLimit         = 2.;
+        co.ArcTolerance       = 0.25;
+        co.ShortestEdgeLength = 0.;
+    }
+
+    static void return_engine(ClipperLib::Clipper &clipper)
+    {
+        clipper.Clear();
+        if (clipper.MemoryRetained() > ClipperEngineMemoryLimit)
+            clipper.Release();
+    }
+
+    static void return_engine(ClipperLib::ClipperOffset &co)
+    {
+        co.Clear();
+        if (co.MemoryRetained() > ClipperEngineMemoryLimit)
+            co.Release();
+    }
+
+    template<typename Engine>
+    ThreadLocalEngine<Engine>::ThreadLocalEngine()
+    {
+        ThreadEngineSlot<Engine> &slot = thread_engine_slot<Engine>();
+        if (slot.borrowed) {
+            m_temporary = std::make_unique<Engine>();
+            m_engine    = m_temporary.get();
+        } else {
+            if (! slot.engine)
+                slot.engine = std::make_unique<Engine>();
+            slot.borrowed = true;
+            m_engine      = slot.engine.get();
+            reset_engine_options(*m_engine);
+        }
+    }
+
+    template<typename Engine>
+    ThreadLocalEngine<Engine>::~ThreadLocalEngine()
+    {
+        if (! m_temporary) {
+            return_engine(*m_engine);
+            thread_engine_slot<Engine>().borrowed = false;
+        }
+    }
+
+    template class ThreadLocalEngine<ClipperLib::Clipper>;
+    template class ThreadLocalEngine<ClipperLib::ClipperOffset>;
 }
 
-static ExPolygons PolyTreeToExPolygons(ClipperLib::PolyTree &&polytree)
+static void append_polygons(Polygons &out, ClipperLib::Paths &&paths)
+{
+    out.reserve(out.size() + paths.size());
+    for (ClipperLib::Path &path : paths)
+        out.emplace_back(std::move(path));
+}
+
+// Append ExPolygons extracted from polytree to out.
+static void PolyTreeToExPolygons(ClipperLib::PolyTree &&polytree, ExPolygons &out)
 {
     struct Inner {
         static void PolyTreeToExPolygonsRecursive(ClipperLib::PolyNode &&polynode, ExPolygons *expolygons)
@@ -236,13 +321,18 @@ static ExPolygons PolyTreeToExPolygons(ClipperLib::PolyTree &&polytree)
         }
     };
 
-    ExPolygons retval;
-    size_t cnt = 0;
+    size_t cnt = out.size();
     for (int i = 0; i < polytree.ChildCount(); ++ i)
         cnt += Inner::PolyTreeCountExPolygons(*polytree.Childs[i]);
-    retval.reserve(cnt);
+    out.reserve(cnt);
     for (int i = 0; i < polytree.ChildCount(); ++ i)
-        Inner::PolyTreeToExPolygonsRecursive(std::move(*polytree.Childs[i]), &retval);
+        Inner::PolyTreeToExPolygonsRecursive(std::move(*polytree.Childs[i]), &out);
+}
+
+static ExPolygons PolyTreeToExPolygons(ClipperLib::PolyTree &&polytree)
+{
+    ExPolygons retval;
+    PolyTreeToExPolygons(std::move(polytree), retval);
     return retval;
 }
 
@@ -310,7 +400,8 @@ static ClipperLib::Paths raw_offset(PathsProvider &&paths, float offset, Clipper
 {
     CLIPPER_UTILS_TIME_LIMIT_MILLIS(CLIPPER_UTILS_TIME_LIMIT_DEFAULT);
 
-    ClipperLib::ClipperOffset co;
+    ClipperUtils::ClipperOffsetEngine co_engine;
+    ClipperLib::ClipperOffset &co = *co_engine;
     ClipperLib::Paths out;
     out.reserve(paths.size());
     ClipperLib::Paths out_this;
@@ -353,7 +444,8 @@ TResult clipper_do(
 {
     CLIPPER_UTILS_TIME_LIMIT_MILLIS(CLIPPER_UTILS_TIME_LIMIT_DEFAULT);
 
-    ClipperLib::Clipper clipper;
+    ClipperUtils::ClipperEngine engine;
+    ClipperLib::Clipper &clipper = *engine;
     clipper.AddPaths(std::forward<TSubj>(subject), ClipperLib::ptSubject, true);
     clipper.AddPaths(std::forward<TClip>(clip),    ClipperLib::ptClip,    true);
     TResult retval;
@@ -384,7 +476,8 @@ TResult clipper_union(
 {
     CLIPPER_UTILS_TIME_LIMIT_MILLIS(CLIPPER_UTILS_TIME_LIMIT_DEFAULT);
 
-    ClipperLib::Clipper clipper;
+    ClipperUtils::ClipperEngine engine;
+    ClipperLib::Clipper &clipper = *engine;
     clipper.AddPaths(std::forward<TSubj>(subject), ClipperLib::ptSubject, true);
     TResult retval;
     clipper.Execute(ClipperLib::ctUnion, retval, fillType, fillType);
@@ -427,7 +520,8 @@ static TResult shrink_paths(PathsProvider &&paths, float offset, ClipperLib::Joi
     assert(offset > 0);
     TResult out;
     if (auto raw = raw_offset(std::forward<PathsProvider>(paths), - offset, joinType, miterLimit); ! raw.empty()) {
-        ClipperLib::Clipper clipper;
+        ClipperUtils::ClipperEngine engine;
+        ClipperLib::Clipper &clipper = *engine;
         clipper.AddPaths(raw, ClipperLib::ptSubject, true);
         ClipperLib::IntRect r = clipper.GetBounds();
         clipper.AddPath({ { r.left - 10, r.bottom + 10 }, { r.right + 10, r.bottom + 10 }, { r.right + 10, r.top - 10 }, { r.left - 10, r.top - 10 } }, ClipperLib::ptSubject, true);
@@ -475,7 +569,8 @@ static int offset_expolygon_inner(const Slic3r::ExPolygon &expoly, const float d
     // 1) Offset the outer contour.
     ClipperLib::Paths contours;
     {
-        ClipperLib::ClipperOffset co;
+        ClipperUtils::ClipperOffsetEngine co_engine;
+        ClipperLib::ClipperOffset &co = *co_engine;
         if (joinType == jtRound)
             co.ArcTolerance = miterLimit;
         else
@@ -496,7 +591,8 @@ static int offset_expolygon_inner(const Slic3r::ExPolygon &expoly, const float d
         ClipperLib::Paths holes;
         {
             for (const Polygon &hole : expoly.holes) {
-                ClipperLib::ClipperOffset co;
+                ClipperUtils::ClipperOffsetEngine co_engine;
+                ClipperLib::ClipperOffset &co = *co_engine;
                 if (joinType == jtRound)
                     co.ArcTolerance = miterLimit;
                 else
@@ -815,6 +911,8 @@ Slic3r::ExPolygons intersection_ex(const Slic3r::Surfaces &subject, const Slic3r
     { return _clipper_ex(ClipperLib::ctIntersection, ClipperUtils::SurfacesProvider(subject), ClipperUtils::ExPolygonsProvider(clip), do_safety_offset); }
 Slic3r::ExPolygons intersection_ex(const Slic3r::Surfaces &subject, const Slic3r::Surfaces &clip, ApplySafetyOffset do_safety_offset)
     { return _clipper_ex(ClipperLib::ctIntersection, ClipperUtils::SurfacesProvider(subject), ClipperUtils::SurfacesProvider(clip), do_safety_offset); }
+Slic3r::ExPolygons intersection_ex(const Slic3r::SurfacesPtr &subject, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset)
+    { return _clipper_ex(ClipperLib::ctIntersection, ClipperUtils::SurfacesPtrProvider(subject), ClipperUtils::PolygonsProvider(clip), do_safety_offset); }
 Slic3r::ExPolygons intersection_ex(const Slic3r::SurfacesPtr &subject, const Slic3r::ExPolygons &clip, ApplySafetyOffset do_safety_offset)
     { return _clipper_ex(ClipperLib::ctIntersection, ClipperUtils::SurfacesPtrProvider(subject), ClipperUtils::ExPolygonsProvider(clip), do_safety_offset); }
 // May be used to "heal" unusual models (3DLabPrints etc.) by providing fill_type (pftEvenOdd, pftNonZero, pftPositive, pftNegative).
@@ -833,6 +931,36 @@ Slic3r::ExPolygons union_ex(const Slic3r::ExPolygons &subject, const Slic3r::Pol
 Slic3r::ExPolygons union_ex(const Slic3r::Surfaces &subject)
     { return PolyTreeToExPolygons(clipper_do_polytree(ClipperLib::ctUnion, ClipperUtils::SurfacesProvider(subject), ClipperUtils::EmptyPathsProvider(), ClipperLib::pftNonZero)); }
 
+// Variants appending the result to an existing container.
+template<class TSubj, class TClip>
+static inline void _clipper(ClipperLib::ClipType clipType, TSubj &&subject, TClip &&clip, ApplySafetyOffset do_safety_offset, Polygons &out)
+{
+    append_polygons(out, clipper_do<ClipperLib::Paths>(clipType, std::forward<TSubj>(subject), std::forward<TClip>(clip), ClipperLib::pftNonZero, do_safety_offset));
+}
+
+template <typename TSubject, typename TClip>
+static void _clipper_ex(ClipperLib::ClipType clipType, TSubject &&subject, TClip &&clip, ApplySafetyOffset do_safety_offset, ExPolygons &out)
+    { PolyTreeToExPolygons(clipper_do_polytree(clipType, std::forward<TSubject>(subject), std::forward<TClip>(clip), ClipperLib::pftNonZero, do_safety_offset), out); }
+
+void append_diff(Slic3r::Polygons &out, const Slic3r::Polygons &subject, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset)
+    { _clipper(ClipperLib::ctDifference, ClipperUtils::PolygonsProvider(subject), ClipperUtils::PolygonsProvider(clip), do_safety_offset, out); }
+void append_diff_ex(Slic3r::ExPolygons &out, const Slic3r::Polygons &subject, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset)
+    { _clipper_ex(ClipperLib::ctDifference, ClipperUtils::PolygonsProvider(subject), ClipperUtils::PolygonsProvider(clip), do_safety_offset, out); }
+void append_diff_ex(Slic3r::ExPolygons &out, const Slic3r::ExPolygons &subject, const Slic3r::ExPolygons &clip, ApplySafetyOffset do_safety_offset)
+    { _clipper_ex(ClipperLib::ctDifference, ClipperUtils::ExPolygonsProvider(subject), ClipperUtils::ExPolygonsProvider(clip), do_safety_offset, out); }
+void append_intersection(Slic3r::Polygons &out, const Slic3r::Polygons &subject, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset)
+    { _clipper(ClipperLib::ctIntersection, ClipperUtils::PolygonsProvider(subject), ClipperUtils::PolygonsProvider(clip), do_safety_offset, out); }
+void append_intersection_ex(Slic3r::ExPolygons &out, const Slic3r::Polygons &subject, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset)
+    { _clipper_ex(ClipperLib::ctIntersection, ClipperUtils::PolygonsProvider(subject), ClipperUtils::PolygonsProvider(clip), do_safety_offset, out); }
+void append_intersection_ex(Slic3r::ExPolygons &out, const Slic3r::ExPolygons &subject, const Slic3r::ExPolygons &clip, ApplySafetyOffset do_safety_offset)
+    { _clipper_ex(ClipperLib::ctIntersection, ClipperUtils::ExPolygonsProvider(subject), ClipperUtils::ExPolygonsProvider(clip), do_safety_offset, out); }
+void append_union(Slic3r::Polygons &out, const Slic3r::Polygons &subject)
+    { _clipper(ClipperLib::ctUnion, ClipperUtils::PolygonsProvider(subject), ClipperUtils::EmptyPathsProvider(), ApplySafetyOffset::No, out); }
+void append_union_ex(Slic3r::ExPolygons &out, const Slic3r::Polygons &subject)
+    { _clipper_ex(ClipperLib::ctUnion, ClipperUtils::PolygonsProvider(subject), ClipperUtils::EmptyPathsProvider(), ApplySafetyOffset::No, out); }
+void append_union_ex(Slic3r::ExPolygons &out, const Slic3r::ExPolygons &subject)
+    { _clipper_ex(ClipperLib::ctUnion, ClipperUtils::ExPolygonsProvider(subject), ClipperUtils::EmptyPathsProvider(), ApplySafetyOffset::No, out); }
+
 Slic3r::ExPolygons xor_ex(const Slic3r::ExPolygons &subject, const Slic3r::ExPolygon &clip, ApplySafetyOffset do_safety_offset)
     { return _clipper_ex(ClipperLib::ctXor, ClipperUtils::ExPolygonsProvider(subject), ClipperUtils::ExPolygonProvider(clip), do_safety_offset); }
 Slic3r::ExPolygons xor_ex(const Slic3r::ExPolygons &subject, const Slic3r::ExPolygons &clip, ApplySafetyOffset do_safety_offset)
@@ -843,7 +971,8 @@ Polylines _clipper_pl_open(ClipperLib::ClipType clipType, PathsProvider1 &&subje
 {
     CLIPPER_UTILS_TIME_LIMIT_MILLIS(CLIPPER_UTILS_TIME_LIMIT_DEFAULT);
 
-    ClipperLib::Clipper clipper;
+    ClipperUtils::ClipperEngine engine;
+    ClipperLib::Clipper &clipper = *engine;
     clipper.AddPaths(std::forward<PathsProvider1>(subject), ClipperLib::ptSubject, false);
     clipper.AddPaths(std::forward<PathsProvider2>(clip), ClipperLib::ptClip, true);
     ClipperLib::PolyTree retval;
@@ -1041,6 +1170,293 @@ Polygons union_parallel_reduce(const Polygons &subject)
         });
 }
 
+namespace ClipperUtils {
+    // PathsProvider over pointers to paths, gathered from multiple sources.
+    class PointsPtrsProvider {
+    public:
+        PointsPtrsProvider(const std::vector<const Points*> &paths) : m_paths(paths) {}
+
+        struct iterator : public PathsProviderIteratorBase {
+        public:
+            explicit iterator(std::vector<const Points*>::const_iterator it) : m_it(it) {}
+            const Points& operator*() const { return **m_it; }
+            bool operator==(const iterator &rhs) const { return m_it == rhs.m_it; }
+            bool operator!=(const iterator &rhs) const { return !(*this == rhs); }
+            const Points& operator++(int) { return **(m_it ++); }
+            iterator& operator++() { ++ m_it; return *this; }
+        private:
+            std::vector<const Points*>::const_iterator m_it;
+        };
+
+        iterator cbegin() const { return iterator(m_paths.begin()); }
+        iterator begin()  const { return this->cbegin(); }
+        iterator cend()   const { return iterator(m_paths.end()); }
+        iterator end()    const { return this->cend(); }
+        size_t   size()   const { return m_paths.size(); }
+
+    private:
+        const std::vector<const Points*> &m_paths;
+    };
+}
+
+// Input of the parallel boolean operations, partitioned by the bounding boxes of the input polygons.
+struct PartitionedPaths
+{
+    struct Item {
+        // Bounding box of the contour, enlarged by the offset applied before the boolean operation.
+        BoundingBox bbox;
+        // Range of paths of this item (ExPolygon contour and holes or a single Polygon).
+        uint32_t    begin;
+        uint32_t    end;
+        bool        clip;
+        // A union of a subset of items is a union of their regions, thus the items may be united tile by tile.
+        // True for ExPolygons and for CCW Polygons, not for the CW Polygons, which may be holes of other Polygons.
+        bool        region;
+    };
+
+    std::vector<const Points*>  paths;
+    std::vector<Item>           items;
+
+    void add(const Points &contour, const Polygons *holes, bool clip, bool region, coord_t inflate) {
+        if (contour.empty())
+            return;
+        Item item;
+        item.bbox.min = item.bbox.max = contour.front();
+        for (const Point &pt : contour) {
+            item.bbox.min = item.bbox.min.cwiseMin(pt);
+            item.bbox.max = item.bbox.max.cwiseMax(pt);
+        }
+        item.bbox.min -= Point(inflate, inflate);
+        item.bbox.max += Point(inflate, inflate);
+        item.bbox.defined = true;
+        item.begin  = uint32_t(paths.size());
+        paths.emplace_back(&contour);
+        if (holes)
+            for (const Polygon &hole : *holes)
+                paths.emplace_back(&hole.points);
+        item.end    = uint32_t(paths.size());
+        item.clip   = clip;
+        item.region = region;
+        items.emplace_back(item);
+    }
+    void add(const Polygons &polygons, bool clip, coord_t inflate) {
+        for (const Polygon &polygon : polygons)
+            this->add(polygon.points, nullptr, clip, ClipperLib::Orientation(polygon.points), inflate);
+    }
+    void add(const ExPolygons &expolygons, bool clip, coord_t inflate) {
+        for (const ExPolygon &expolygon : expolygons)
+            this->add(expolygon.contour.points, &expolygon.holes, clip, true, inflate);
+    }
+
+    // Gather paths of the given items.
+    std::vector<const Points*> gather(const std::vector<uint32_t> &items_idx, bool clip) const {
+        std::vector<const Points*> out;
+        for (uint32_t idx : items_idx)
+            if (const Item &item = items[idx]; item.clip == clip)
+                out.insert(out.end(), paths.begin() + item.begin, paths.begin() + item.end);
+        return out;
+    }
+
+    // Split items into clusters of items with transitively overlapping bounding boxes.
+    // Items of different clusters do not interact in a boolean operation, thus the clusters may be processed independently.
+    // Items of a cluster are sorted by their index, clusters are sorted by the index of their first item.
+    std::vector<std::vector<uint32_t>> clusters() const {
+        auto overlap = [](const BoundingBox &a, const BoundingBox &b) {
+            return a.min.x() <= b.max.x() && b.min.x() <= a.max.x() && a.min.y() <= b.max.y() && b.min.y() <= a.max.y();
+        };
+        std::vector<uint32_t> parent(items.size());
+        std::iota(parent.begin(), parent.end(), 0);
+        auto find = [&parent](uint32_t i) {
+            while (parent[i] != i)
+                i = parent[i] = parent[parent[i]];
+            return i;
+        };
+        // Sweep the items along the X axis, maintaining bounding boxes of the active clusters.
+        // Merging the bounding boxes of a cluster may merge clusters, which would not need to be merged, which is harmless.
+        std::vector<uint32_t> order(items.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [this](uint32_t l, uint32_t r){ return items[l].bbox.min.x() < items[r].bbox.min.x(); });
+        std::vector<std::pair<BoundingBox, uint32_t>> active;
+        for (uint32_t idx : order) {
+            BoundingBox bbox = items[idx].bbox;
+            // Retire the clusters left of this item.
+            active.erase(std::remove_if(active.begin(), active.end(),
+                [&bbox](const std::pair<BoundingBox, uint32_t> &a){ return a.first.max.x() < bbox.min.x(); }), active.end());
+            uint32_t root = idx;
+            for (auto it = active.begin(); it != active.end();)
+                if (overlap(it->first, bbox)) {
+                    bbox.min = bbox.min.cwiseMin(it->first.min);
+                    bbox.max = bbox.max.cwiseMax(it->first.max);
+                    parent[find(it->second)] = root;
+                    *it = active.back();
+                    active.pop_back();
+                } else
+                    ++ it;
+            active.emplace_back(bbox, root);
+        }
+        std::vector<std::vector<uint32_t>> out;
+        std::vector<uint32_t>              cluster_idx(items.size(), std::numeric_limits<uint32_t>::max());
+        for (uint32_t idx = 0; idx < uint32_t(items.size()); ++ idx) {
+            uint32_t &cluster = cluster_idx[find(idx)];
+            if (cluster == std::numeric_limits<uint32_t>::max()) {
+                cluster = uint32_t(out.size());
+                out.emplace_back();
+            }
+            out[cluster].emplace_back(idx);
+        }
+        return out;
+    }
+};
+
+// Process the clusters in parallel, larger clusters first. The results are returned in the order of the clusters.
+template<typename ClusterFn>
+static auto process_clusters_parallel(const std::vector<std::vector<uint32_t>> &clusters, ClusterFn &&fn)
+{
+    using Result = decltype(fn(clusters.front()));
+    std::vector<Result>   results(clusters.size());
+    std::vector<uint32_t> order(clusters.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&clusters](uint32_t l, uint32_t r){ return clusters[l].size() > clusters[r].size(); });
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, order.size(), 1), [&clusters, &fn, &results, &order](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++ i)
+            results[order[i]] = fn(clusters[order[i]]);
+    });
+    return results;
+}
+
+// Inputs smaller than this are processed serially.
+static constexpr const size_t ParallelBooleanMinPaths   = 64;
+// A cluster with at least this number of items is split into tiles for union.
+static constexpr const size_t ParallelUnionMinItemsTile = 64;
+static constexpr const size_t ParallelUnionItemsPerTile = 32;
+// The number of tiles does not depend on the number of threads, so that neither does the result.
+static constexpr const size_t ParallelUnionMaxTiles     = 64;
+
+struct ParallelUnionParams
+{
+    // Offset applied to each path before the union, zero for no offset.
+    float                   delta      { 0.f };
+    ClipperLib::JoinType    joinType   { DefaultJoinType };
+    double                  miterLimit { DefaultMiterLimit };
+};
+
+static ClipperLib::Paths union_paths(const std::vector<const Points*> &paths, const ParallelUnionParams &params)
+{
+    return params.delta > 0 ?
+        expand_paths<ClipperLib::Paths>(ClipperUtils::PointsPtrsProvider(paths), params.delta, params.joinType, params.miterLimit) :
+        clipper_union<ClipperLib::Paths>(ClipperUtils::PointsPtrsProvider(paths));
+}
+
+// Union of a single cluster. A large cluster is split into tiles along its longer axis, the tiles are united in parallel
+// and the seams are merged by a final union of the tiles.
+static ClipperLib::Paths union_cluster(const PartitionedPaths &input, const std::vector<uint32_t> &cluster, const ParallelUnionParams &params)
+{
+    if (cluster.size() < ParallelUnionMinItemsTile ||
+        std::any_of(cluster.begin(), cluster.end(), [&input](uint32_t idx){ return ! input.items[idx].region; }))
+        return union_paths(input.gather(cluster, false), params);
+
+    BoundingBox bbox = input.items[cluster.front()].bbox;
+    for (uint32_t idx : cluster) {
+        bbox.min = bbox.min.cwiseMin(input.items[idx].bbox.min);
+        bbox.max = bbox.max.cwiseMax(input.items[idx].bbox.max);
+    }
+    const int axis = bbox.max.x() - bbox.min.x() > bbox.max.y() - bbox.min.y() ? 0 : 1;
+    std::vector<uint32_t> sorted = cluster;
+    std::sort(sorted.begin(), sorted.end(), [&input, axis](uint32_t l, uint32_t r) {
+        const BoundingBox &bl = input.items[l].bbox;
+        const BoundingBox &br = input.items[r].bbox;
+        return bl.min(axis) + bl.max(axis) < br.min(axis) + br.max(axis);
+    });
+    const size_t num_tiles = std::clamp<size_t>(cluster.size() / ParallelUnionItemsPerTile, 2, ParallelUnionMaxTiles);
+    std::vector<ClipperLib::Paths> tiles(num_tiles);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_tiles, 1), [&input, &params, &sorted, &tiles, num_tiles](const tbb::blocked_range<size_t> &range) {
+        for (size_t tile = range.begin(); tile < range.end(); ++ tile) {
+            std::vector<uint32_t> items(sorted.begin() + tile * sorted.size() / num_tiles, sorted.begin() + (tile + 1) * sorted.size() / num_tiles);
+            tiles[tile] = union_paths(input.gather(items, false), params);
+        }
+    });
+    ClipperLib::Paths merged;
+    for (ClipperLib::Paths &tile : tiles)
+        append(merged, std::move(tile));
+    return clipper_union<ClipperLib::Paths>(merged);
+}
+
+template<typename ResultFn>
+static auto union_parallel_clusters(const PartitionedPaths &input, const ParallelUnionParams &params, ResultFn &&result_fn)
+{
+    return process_clusters_parallel(input.clusters(), [&input, &params, &result_fn](const std::vector<uint32_t> &cluster) {
+        return result_fn(union_cluster(input, cluster, params));
+    });
+}
+
+static Polygons union_parallel(const PartitionedPaths &input, const ParallelUnionParams &params)
+{
+    std::vector<ClipperLib::Paths> results = union_parallel_clusters(input, params, [](ClipperLib::Paths &&paths) { return std::move(paths); });
+    Polygons out;
+    out.reserve(std::accumulate(results.begin(), results.end(), size_t(0), [](size_t n, const ClipperLib::Paths &paths){ return n + paths.size(); }));
+    for (ClipperLib::Paths &paths : results)
+        append_polygons(out, std::move(paths));
+    // Order the polygons by their lowest point rather than by the clusters, so that the order does not depend on the clustering.
+    auto lower = [](const Point &l, const Point &r) { return l.y() < r.y() || (l.y() == r.y() && l.x() < r.x()); };
+    std::vector<std::pair<Point, size_t>> lowest;
+    lowest.reserve(out.size());
+    for (size_t i = 0; i < out.size(); ++ i)
+        lowest.emplace_back(*std::min_element(out[i].points.begin(), out[i].points.end(), lower), i);
+    std::sort(lowest.begin(), lowest.end(), [&lower](const std::pair<Point, size_t> &l, const std::pair<Point, size_t> &r) {
+        return lower(l.first, r.first) || (l.first == r.first && l.second < r.second);
+    });
+    Polygons sorted;
+    sorted.reserve(out.size());
+    for (const std::pair<Point, size_t> &l : lowest)
+        sorted.emplace_back(std::move(out[l.second]));
+    return sorted;
+}
+
+Polygons union_parallel(const Polygons &subject)
+{
+    if (subject.size() < ParallelBooleanMinPaths)
+        return union_(subject);
+    PartitionedPaths input;
+    input.add(subject, false, 0);
+    return union_parallel(input, {});
+}
+
+Polygons expand_parallel(const Polygons &polygons, const float delta, ClipperLib::JoinType joinType, double miterLimit)
+{
+    assert(delta > 0);
+    if (polygons.size() < ParallelBooleanMinPaths)
+        return expand(polygons, delta, joinType, miterLimit);
+    // The furthest an offset vertex may get from its source vertex: A round join stays at delta, a square join reaches
+    // delta * sqrt(2) at a sharp corner and a miter join reaches delta * miterLimit, Clipper clamps miterLimit to at least 2.
+    const double reach = joinType == ClipperLib::jtRound  ? 1. :
+                         joinType == ClipperLib::jtSquare ? std::sqrt(2.) : std::max(miterLimit, 2.);
+    PartitionedPaths input;
+    // Inflate the bounding boxes by the reach of the offset, so that the items, which will overlap after the offset, are clustered together.
+    input.add(polygons, false, coord_t(std::ceil(delta * reach)) + SCALED_EPSILON);
+    return union_parallel(input, { delta, joinType, miterLimit });
+}
+
+ExPolygons diff_ex_parallel(const ExPolygons &subject, const ExPolygons &clip)
+{
+    if (subject.size() + clip.size() < ParallelBooleanMinPaths)
+        return diff_ex(subject, clip);
+    PartitionedPaths input;
+    input.add(subject, false, 0);
+    input.add(clip, true, 0);
+    ExPolygons out;
+    for (ExPolygons &expolygons : process_clusters_parallel(input.clusters(), [&input](const std::vector<uint32_t> &cluster) {
+            std::vector<const Points*> subject_paths = input.gather(cluster, false);
+            if (subject_paths.empty())
+                return ExPolygons();
+            std::vector<const Points*> clip_paths = input.gather(cluster, true);
+            ClipperLib::Paths paths = clipper_do<ClipperLib::Paths>(ClipperLib::ctDifference,
+                ClipperUtils::PointsPtrsProvider(subject_paths), ClipperUtils::PointsPtrsProvider(clip_paths), ClipperLib::pftNonZero);
+            return paths.empty() ? ExPolygons() : PolyTreeToExPolygons(clipper_union<ClipperLib::PolyTree>(paths));
+        }))
+        append(out, std::move(expolygons));
+    return out;
+}
+
 Polygons simplify_polygons(const Polygons &subject) {    
     CLIPPER_UTILS_TIME_LIMIT_MILLIS(CLIPPER_UTILS_TIME_LIMIT_DEFAULT);
 
@@ -11,6 +11,7 @@
 #include <assert.h>
 #include <cstddef>
 #include <iterator>
+#include <memory>
 #include <utility>
 #include <vector>
 #include <cassert>
@@ -349,6 +350,32 @@ namespace ClipperUtils {
     [[nodiscard]] Polygons  clip_clipper_polygons_with_subject_bbox(const Polygons &src, const BoundingBox &bbox);
     [[nodiscard]] Polygons  clip_clipper_polygons_with_subject_bbox(const ExPolygon &src, const BoundingBox &bbox);
     [[nodiscard]] Polygons  clip_clipper_polygons_with_subject_bbox(const ExPolygons &src, const BoundingBox &bbox);
+
+    // Clipper engine retained by the calling thread, borrowed for the life time of this object.
+    // The engine is cleared when returned, keeping its internal buffers (edges, local minima, scanbeam, output points)
+    // allocated for the next boolean operation or offset executed by the same thread.
+    // If the engine of the calling thread is borrowed already (nested use), a temporary engine is constructed instead.
+    // The engine options are reset to their defaults when borrowed.
+    template<typename Engine>
+    class ThreadLocalEngine
+    {
+    public:
+        ThreadLocalEngine();
+        ~ThreadLocalEngine();
+        ThreadLocalEngine(const ThreadLocalEngine &) = delete;
+        ThreadLocalEngine& operator=(const ThreadLocalEngine &) = delete;
+
+        Engine& operator*()  { return *m_engine; }
+        Engine* operator->() { return m_engine; }
+
+    private:
+        Engine                  *m_engine;
+        // Only valid for the nested use.
+        std::unique_ptr<Engine>  m_temporary;
+    };
+
+    using ClipperEngine       = ThreadLocalEngine<ClipperLib::Clipper>;
+    using ClipperOffsetEngine = ThreadLocalEngine<ClipperLib::ClipperOffset>;
 }
 
 // offset Polygons
@@ -463,6 +490,10 @@ Slic3r::ExPolygons diff_ex(const Slic3r::ExPolygons &subject, const Slic3r::Surf
 Slic3r::ExPolygons diff_ex(const Slic3r::Surfaces &subject, const Slic3r::Surfaces &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
 Slic3r::ExPolygons diff_ex(const Slic3r::SurfacesPtr &subject, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
 Slic3r::ExPolygons diff_ex(const Slic3r::SurfacesPtr &subject, const Slic3r::ExPolygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+// Variants appending the result to an existing container, so that its capacity may be reused, for example when called in a loop.
+void               append_diff(Slic3r::Polygons &out, const Slic3r::Polygons &subject, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+void               append_diff_ex(Slic3r::ExPolygons &out, const Slic3r::Polygons &subject, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+void               append_diff_ex(Slic3r::ExPolygons &out, const Slic3r::ExPolygons &subject, const Slic3r::ExPolygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
 Slic3r::Polylines  diff_pl(const Slic3r::Polyline &subject, const Slic3r::Polygons &clip);
 Slic3r::Polylines  diff_pl(const Slic3r::Polylines &subject, const Slic3r::Polygons &clip);
 Slic3r::Polylines  diff_pl(const Slic3r::Polyline &subject, const Slic3r::ExPolygon &clip);
@@ -497,7 +528,12 @@ Slic3r::ExPolygons intersection_ex(const Slic3r::ExPolygons &subject, const Slic
 Slic3r::ExPolygons intersection_ex(const Slic3r::Surfaces &subject, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
 Slic3r::ExPolygons intersection_ex(const Slic3r::Surfaces &subject, const Slic3r::ExPolygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
 Slic3r::ExPolygons intersection_ex(const Slic3r::Surfaces &subject, const Slic3r::Surfaces &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+Slic3r::ExPolygons intersection_ex(const Slic3r::SurfacesPtr &subject, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
 Slic3r::ExPolygons intersection_ex(const Slic3r::SurfacesPtr &subject, const Slic3r::ExPolygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+// Variants appending the result to an existing container.
+void               append_intersection(Slic3r::Polygons &out, const Slic3r::Polygons &subject, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+void               append_intersection_ex(Slic3r::ExPolygons &out, const Slic3r::Polygons &subject, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+void               append_intersection_ex(Slic3r::ExPolygons &out, const Slic3r::ExPolygons &subject, const Slic3r::ExPolygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
 Slic3r::Polylines  intersection_pl(const Slic3r::Polylines &subject, const Slic3r::Polygon &clip);
 Slic3r::Polylines  intersection_pl(const Slic3r::Polyline &subject, const Slic3r::ExPolygon &clip);
 Slic3r::Polylines  intersection_pl(const Slic3r::Polylines &subject, const Slic3r::ExPolygon &clip);
@@ -533,6 +569,10 @@ Slic3r::ExPolygons union_ex(const Slic3r::ExPolygons &subject, const Slic3r::ExP
 Slic3r::ExPolygons union_ex(const Slic3r::ExPolygons &subject, const Slic3r::Polygons &subject2);
 Slic3r::ExPolygons union_ex(const Slic3r::Polygons &subject, const Slic3r::ExPolygons &subject2);
 Slic3r::ExPolygons union_ex(const Slic3r::Surfaces &subject);
+// Variants appending the result to an existing container.
+void append_union(Slic3r::Polygons &out, const Slic3r::Polygons &subject);
+void append_union_ex(Slic3r::ExPolygons &out, const Slic3r::Polygons &subject);
+void append_union_ex(Slic3r::ExPolygons &out, const Slic3r::ExPolygons &subject);
 
 // Convert polygons / expolygons into ClipperLib::PolyTree using ClipperLib::pftEvenOdd, thus union will NOT be performed.
 // If the contours are not intersecting, their orientation shall not be modified by union_pt().
@@ -546,6 +586,16 @@ Slic3r::Polygons union_pt_chained_outside_in(const Slic3r::Polygons &subject);
 // However, performing the union operation incrementally can be significantly faster in such cases.
 Slic3r::Polygons union_parallel_reduce(const Slic3r::Polygons &subject);
 
+// Boolean operations on large sets of polygons, for example on the first layer or on the brim of a densely packed print bed.
+// The input is split into clusters of polygons with transitively overlapping bounding boxes, which are processed in parallel.
+// For a union, a cluster of many polygons is further split into tiles, which are united in parallel,
+// and the seams between the tiles are merged by a final union.
+// The result covers the same area as the result of the serial variant, only the order of the output polygons may differ.
+// union_parallel() and expand_parallel() return the polygons ordered by their lowest point.
+Slic3r::Polygons   union_parallel(const Slic3r::Polygons &subject);
+Slic3r::Polygons   expand_parallel(const Slic3r::Polygons &polygons, const float delta, ClipperLib::JoinType joinType = DefaultJoinType, double miterLimit = DefaultMiterLimit);
+Slic3r::ExPolygons diff_ex_parallel(const Slic3r::ExPolygons &subject, const Slic3r::ExPolygons &clip);
+
 Slic3r::ExPolygons xor_ex(const Slic3r::ExPolygons &subject, const Slic3r::ExPolygon &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
 Slic3r::ExPolygons xor_ex(const Slic3r::ExPolygons &subject, const Slic3r::ExPolygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
 
@@ -7,6 +7,8 @@
 ///|/
 ///|/ PrusaSlicer is released under the terms of the AGPLv3 or higher
 ///|/
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
 #include <oneapi/tbb/scalable_allocator.h>
 #include <boost/container/vector.hpp>
 #include <memory>
@@ -494,6 +496,11 @@ void Layer::make_fills(FillAdaptive::Octree* adaptive_fill_octree, FillAdaptive:
 #endif /* SLIC3R_DEBUG_SLICE_PROCESSING */
 
 	size_t first_object_layer_id = this->object()->get_layer(0)->id();
+    // Fillers and their parameters, one for each SurfaceFill.
+    std::vector<std::unique_ptr<Fill>> fillers;
+    std::vector<FillParams>            fillers_params;
+    fillers.reserve(surface_fills.size());
+    fillers_params.reserve(surface_fills.size());
     for (SurfaceFill &surface_fill : surface_fills) {
         // Create the filler object.
         std::unique_ptr<Fill> f = std::unique_ptr<Fill>(Fill::new_from_type(surface_fill.params.pattern));
@@ -518,7 +525,6 @@ void Layer::make_fills(FillAdaptive::Octree* adaptive_fill_octree, FillAdaptive:
         }
 
         // calculate flow spacing for infill pattern generation
-        bool using_internal_flow = ! surface_fill.surface.is_solid() && ! surface_fill.params.bridge;
         double link_max_length = 0.;
         if (! surface_fill.params.bridge) {
 #if 0
@@ -548,17 +554,41 @@ void Layer::make_fills(FillAdaptive::Octree* adaptive_fill_octree, FillAdaptive:
         params.layer_height               = layerm.layer()->height;
         params.prefer_clockwise_movements = this->object()->print()->config().prefer_clockwise_movements;
 
-        for (ExPolygon &expoly : surface_fill.expolygons) {
+        fillers.emplace_back(std::move(f));
+        fillers_params.emplace_back(params);
+    }
+
+    // Each ExPolygon of each SurfaceFill is filled by a separate task, so that a layer with just a few large SurfaceFills
+    // keeps all the cores busy. This is nested into the parallel processing of layers, which does not fill all the cores
+    // for prints with just a few layers.
+    struct FillTask {
+        size_t                                     surface_fill_idx;
+        size_t                                     expolygon_idx;
+        std::unique_ptr<ExtrusionEntityCollection> eec;
+    };
+    std::vector<FillTask> fill_tasks;
+    for (size_t surface_fill_idx = 0; surface_fill_idx < surface_fills.size(); ++ surface_fill_idx)
+        for (size_t expolygon_idx = 0; expolygon_idx < surface_fills[surface_fill_idx].expolygons.size(); ++ expolygon_idx)
+            fill_tasks.push_back({ surface_fill_idx, expolygon_idx, {} });
+
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, fill_tasks.size(), 1), [&surface_fills, &fillers, &fillers_params, &fill_tasks](const tbb::blocked_range<size_t> &range) {
+        for (size_t task_idx = range.begin(); task_idx < range.end(); ++ task_idx) {
+            FillTask          &task         = fill_tasks[task_idx];
+            SurfaceFill       &surface_fill = surface_fills[task.surface_fill_idx];
+            const FillParams  &params       = fillers_params[task.surface_fill_idx];
+            // The filler is modified while filling, each task works with its own copy.
+            std::unique_ptr<Fill> f(fillers[task.surface_fill_idx]->clone());
+            bool using_internal_flow = ! surface_fill.surface.is_solid() && ! surface_fill.params.bridge;
 			// Spacing is modified by the filler to indicate adjustments. Reset it for each expolygon.
 			f->spacing = surface_fill.params.spacing;
-			surface_fill.surface.expolygon = std::move(expoly);
+            Surface        surface(surface_fill.surface, std::move(surface_fill.expolygons[task.expolygon_idx]));
             Polylines      polylines;
             ThickPolylines thick_polylines;
 			try {
                 if (params.use_arachne)
-                    thick_polylines = f->fill_surface_arachne(&surface_fill.surface, params);
+                    thick_polylines = f->fill_surface_arachne(&surface, params);
                 else
-				    polylines = f->fill_surface(&surface_fill.surface, params);
+				    polylines = f->fill_surface(&surface, params);
 			} catch (InfillFailedException &) {
 			}
             if (!polylines.empty() || !thick_polylines.empty()) {
@@ -575,9 +605,7 @@ void Layer::make_fills(FillAdaptive::Octree* adaptive_fill_octree, FillAdaptive:
 		        	flow_mm3_per_mm = new_flow.mm3_per_mm();
 		        	flow_width      = new_flow.width();
 		        }
-                // Save into layer.
-                ExtrusionEntityCollection *eec        = new ExtrusionEntityCollection();
-                auto                       fill_begin = uint32_t(layerm.fills().size());
+                auto eec = std::make_unique<ExtrusionEntityCollection>();
                 // Only concentric fills are not sorted.
                 eec->no_sort = f->no_sort();
                 if (params.use_arachne) {
@@ -595,11 +623,7 @@ void Layer::make_fills(FillAdaptive::Octree* adaptive_fill_octree, FillAdaptive:
                     }
 
                     if (!eec->empty())
-                        layerm.m_fills.entities.push_back(eec);
-                    else
-                        delete eec;
-
-                    thick_polylines.clear();
+                        task.eec = std::move(eec);
                 } else {
                     // When prefer_clockwise_movements is true, we have to ensure that extrusion paths will not be reversed during path planning.
                     extrusion_entities_append_paths(
@@ -609,12 +633,21 @@ void Layer::make_fills(FillAdaptive::Octree* adaptive_fill_octree, FillAdaptive:
 							ExtrusionFlow{ flow_mm3_per_mm, float(flow_width), surface_fill.params.flow.height() },
                             f->is_self_crossing()
 						}, !params.prefer_clockwise_movements);
-                    layerm.m_fills.entities.push_back(eec);
+                    task.eec = std::move(eec);
                 }
-                insert_fills_into_islands(*this, uint32_t(surface_fill.region_id), fill_begin, uint32_t(layerm.fills().size()));
 		    }
 		}
-    }
+    });
+
+    // Save into layer in the order of the SurfaceFills and their ExPolygons, so that the result does not depend on the scheduling of the tasks.
+    for (FillTask &task : fill_tasks)
+        if (task.eec) {
+            const size_t  region_id  = surface_fills[task.surface_fill_idx].region_id;
+            LayerRegion  &layerm     = *m_regions[region_id];
+            auto          fill_begin = uint32_t(layerm.fills().size());
+            layerm.m_fills.entities.push_back(task.eec.release());
+            insert_fills_into_islands(*this, uint32_t(region_id), fill_begin, uint32_t(layerm.fills().size()));
+        }
 
 	for (LayerSlice &lslice : this->lslices_ex)
 		for (LayerIsland &island : lslice.islands) {
@@ -32,6 +32,10 @@
 #include "libslic3r/PrintConfig.hpp"
 #include "tcbspan/span.hpp"
 
+#include <boost/container_hash/hash.hpp>
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+
 // Boost pool: Don't use mutexes to synchronize memory allocation.
 #define BOOST_POOL_NO_MT
 #include <boost/pool/object_pool.hpp>
@@ -271,15 +275,23 @@ struct Octree
 {
     // Octree will allocate its Cubes from the pool. The pool only supports deletion of the complete pool,
     // perfect for building up our octree.
-    boost::object_pool<Cube>    pool;
-    Cube*                       root_cube { nullptr };
-    Vec3d                       origin;
-    std::vector<CubeProperties> cubes_properties;
+    boost::object_pool<Cube>                pool;
+    // The subtrees of the children of the root cube are built in parallel, each allocating its Cubes from its own pool.
+    std::array<boost::object_pool<Cube>, 8> subtree_pools;
+    Cube*                                   root_cube { nullptr };
+    Vec3d                                   origin;
+    std::vector<CubeProperties>             cubes_properties;
+
+    // Hash of the mesh and of the overhang triangles the octree was built from, and the parameters of the octree,
+    // so that an octree may be reused if rebuilt from the same input.
+    uint64_t                                input_hash { 0 };
+    coordf_t                                line_spacing { 0 };
+    bool                                    support_overhangs_only { false };
 
     Octree(const Vec3d &origin, const std::vector<CubeProperties> &cubes_properties)
         : root_cube(pool.construct(origin)), origin(origin), cubes_properties(cubes_properties) {}
 
-    void insert_triangle(const Vec3d &a, const Vec3d &b, const Vec3d &c, Cube *current_cube, const BoundingBoxf3 &current_bbox, int depth);
+    void insert_triangle(const Vec3d &a, const Vec3d &b, const Vec3d &c, Cube *current_cube, const BoundingBoxf3 &current_bbox, int depth, boost::object_pool<Cube> &pool);
 };
 
 void OctreeDeleter::operator()(Octree *p) {
@@ -1471,6 +1483,34 @@ static void transform_center(Cube *current_cube, const Eigen::Matrix3d &rot)
             transform_center(child, rot);
 }
 
+static uint64_t octree_input_hash(const indexed_triangle_set &triangle_mesh, const std::vector<Vec3d> &overhang_triangles)
+{
+    size_t seed = size_t(its_content_hash(triangle_mesh));
+    boost::hash_combine(seed, overhang_triangles.size());
+    for (const Vec3d &v : overhang_triangles)
+        for (int i = 0; i < 3; ++ i)
+            boost::hash_combine(seed, v[i]);
+    return uint64_t(seed);
+}
+
+// Slightly expanded bounding box of a child cube to cope with triangles touching a cube wall and other numeric errors.
+// We will rather densify the octree a bit more than necessary instead of missing a triangle.
+static BoundingBoxf3 child_cube_bbox(const Cube &cube, const BoundingBoxf3 &cube_bbox, size_t child_idx)
+{
+    const Vec3d  &child_center_dir = child_centers[child_idx];
+    BoundingBoxf3 bbox;
+    for (int k = 0; k < 3; ++ k) {
+        if (child_center_dir[k] == -1.) {
+            bbox.min[k] = cube_bbox.min[k];
+            bbox.max[k] = cube.center[k] + EPSILON;
+        } else {
+            bbox.min[k] = cube.center[k] - EPSILON;
+            bbox.max[k] = cube_bbox.max[k];
+        }
+    }
+    return bbox;
+}
+
 OctreePtr build_octree(
     // Mesh is rotated to the coordinate system of the octree.
     const indexed_triangle_set  &triangle_mesh,
@@ -1478,38 +1518,72 @@ OctreePtr build_octree(
     // rotated to the coordinate system of the octree.
     const std::vector<Vec3d>    &overhang_triangles, 
     coordf_t                     line_spacing,
-    bool                         support_overhangs_only)
+    bool                         support_overhangs_only,
+    OctreePtr                  &&previous)
 {
     assert(line_spacing > 0);
     assert(! std::isnan(line_spacing));
 
+    const uint64_t input_hash = octree_input_hash(triangle_mesh, overhang_triangles);
+    if (previous && previous->input_hash == input_hash && previous->line_spacing == line_spacing && previous->support_overhangs_only == support_overhangs_only)
+        // Built from the same input already.
+        return std::move(previous);
+    previous.reset();
+
     BoundingBox3Base<Vec3f>     bbox(triangle_mesh.vertices);
     Vec3d                       cube_center      = bbox.center().cast<double>();
     std::vector<CubeProperties> cubes_properties = make_cubes_properties(double(bbox.size().maxCoeff()), line_spacing);
     auto                        octree           = OctreePtr(new Octree(cube_center, cubes_properties));
+    octree->input_hash             = input_hash;
+    octree->line_spacing           = line_spacing;
+    octree->support_overhangs_only = support_overhangs_only;
 
     if (cubes_properties.size() > 1) {
+        // Indices of the mesh triangles to be inserted into the octree.
+        std::vector<uint32_t> mesh_triangles;
+        if (support_overhangs_only) {
+            auto up_vector = Vec3d(transform_to_octree() * Vec3d(0., 0., 1.));
+            for (uint32_t idx = 0; idx < uint32_t(triangle_mesh.indices.size()); ++ idx) {
+                const stl_triangle_vertex_indices &tri = triangle_mesh.indices[idx];
+                if (is_overhang_triangle(triangle_mesh.vertices[tri[0]].cast<double>(), triangle_mesh.vertices[tri[1]].cast<double>(), triangle_mesh.vertices[tri[2]].cast<double>(), up_vector))
+                    mesh_triangles.emplace_back(idx);
+            }
+        } else {
+            mesh_triangles.assign(triangle_mesh.indices.size(), 0);
+            std::iota(mesh_triangles.begin(), mesh_triangles.end(), 0);
+        }
+
+        // Build the subtrees of the children of the root cube in parallel.
+        // The resulting octree does not depend on the order of insertion of the triangles.
         Octree *octree_ptr = octree.get();
         double edge_length_half = 0.5 * cubes_properties.back().edge_length;
         Vec3d  diag_half(edge_length_half, edge_length_half, edge_length_half);
-        int    max_depth = int(cubes_properties.size()) - 1;
-        auto process_triangle = [octree_ptr, max_depth, diag_half](const Vec3d &a, const Vec3d &b, const Vec3d &c) {
-            octree_ptr->insert_triangle(
-                a, b, c,
-                octree_ptr->root_cube,
-                BoundingBoxf3(octree_ptr->root_cube->center - diag_half, octree_ptr->root_cube->center + diag_half),
-                max_depth);
-        };
-        auto up_vector = support_overhangs_only ? Vec3d(transform_to_octree() * Vec3d(0., 0., 1.)) : Vec3d();
-        for (auto &tri : triangle_mesh.indices) {
-            auto a = triangle_mesh.vertices[tri[0]].cast<double>();
-            auto b = triangle_mesh.vertices[tri[1]].cast<double>();
-            auto c = triangle_mesh.vertices[tri[2]].cast<double>();
-            if (! support_overhangs_only || is_overhang_triangle(a, b, c, up_vector))
-                process_triangle(a, b, c);
-        }
-        for (size_t i = 0; i < overhang_triangles.size(); i += 3)
-            process_triangle(overhang_triangles[i], overhang_triangles[i + 1], overhang_triangles[i + 2]);
+        const BoundingBoxf3 root_bbox(octree_ptr->root_cube->center - diag_half, octree_ptr->root_cube->center + diag_half);
+        const int           depth = int(cubes_properties.size()) - 2;
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, 8, 1), [octree_ptr, &triangle_mesh, &mesh_triangles, &overhang_triangles, &root_bbox, depth](const tbb::blocked_range<size_t> &range) {
+            for (size_t child_idx = range.begin(); child_idx < range.end(); ++ child_idx) {
+                Cube                     &root         = *octree_ptr->root_cube;
+                boost::object_pool<Cube> &pool         = octree_ptr->subtree_pools[child_idx];
+                const BoundingBoxf3       bbox         = child_cube_bbox(root, root_bbox, child_idx);
+                const Vec3d               child_center = root.center + (child_centers[child_idx] * (octree_ptr->cubes_properties[depth].edge_length / 2.));
+                Cube                     *child        = nullptr;
+                auto process_triangle = [octree_ptr, &pool, &bbox, &child_center, &child, depth](const Vec3d &a, const Vec3d &b, const Vec3d &c) {
+                    if (triangle_AABB_intersects(a, b, c, bbox)) {
+                        if (! child)
+                            child = pool.construct(child_center);
+                        if (depth > 0)
+                            octree_ptr->insert_triangle(a, b, c, child, bbox, depth, pool);
+                    }
+                };
+                for (uint32_t idx : mesh_triangles) {
+                    const stl_triangle_vertex_indices &tri = triangle_mesh.indices[idx];
+                    process_triangle(triangle_mesh.vertices[tri[0]].cast<double>(), triangle_mesh.vertices[tri[1]].cast<double>(), triangle_mesh.vertices[tri[2]].cast<double>());
+                }
+                for (size_t i = 0; i < overhang_triangles.size(); i += 3)
+                    process_triangle(overhang_triangles[i], overhang_triangles[i + 1], overhang_triangles[i + 2]);
+                root.children[child_idx] = child;
+            }
+        });
         {
             // Transform the octree to world coordinates to reduce computation when extracting infill lines.
             auto rot = transform_to_world().toRotationMatrix();
@@ -1521,7 +1595,21 @@ OctreePtr build_octree(
     return octree;
 }
 
-void Octree::insert_triangle(const Vec3d &a, const Vec3d &b, const Vec3d &c, Cube *current_cube, const BoundingBoxf3 &current_bbox, int depth)
+std::vector<std::pair<int, Vec3d>> octree_cubes(const Octree &octree)
+{
+    std::vector<std::pair<int, Vec3d>> out;
+    auto collect = [&out](const Cube *cube, int depth, auto &collect) -> void {
+        out.emplace_back(depth, cube->center);
+        for (const Cube *child : cube->children)
+            if (child)
+                collect(child, depth + 1, collect);
+    };
+    if (octree.root_cube)
+        collect(octree.root_cube, 0, collect);
+    return out;
+}
+
+void Octree::insert_triangle(const Vec3d &a, const Vec3d &b, const Vec3d &c, Cube *current_cube, const BoundingBoxf3 &current_bbox, int depth, boost::object_pool<Cube> &pool)
 {
     assert(current_cube);
     assert(depth > 0);
@@ -1532,27 +1620,15 @@ void Octree::insert_triangle(const Vec3d &a, const Vec3d &b, const Vec3d &c, Cub
     // const double r2_cube = Slic3r::sqr(0.5 * this->cubes_properties[depth].height + EPSILON);
 
     for (size_t i = 0; i < 8; ++ i) {
-        const Vec3d &child_center_dir = child_centers[i];
-        // Calculate a slightly expanded bounding box of a child cube to cope with triangles touching a cube wall and other numeric errors.
-        // We will rather densify the octree a bit more than necessary instead of missing a triangle.
-        BoundingBoxf3 bbox;
-        for (int k = 0; k < 3; ++ k) {
-            if (child_center_dir[k] == -1.) {
-                bbox.min[k] = current_bbox.min[k];
-                bbox.max[k] = current_cube->center[k] + EPSILON;
-            } else {
-                bbox.min[k] = current_cube->center[k] - EPSILON;
-                bbox.max[k] = current_bbox.max[k];
-            }
-        }
-        Vec3d child_center = current_cube->center + (child_center_dir * (this->cubes_properties[depth].edge_length / 2.));
+        BoundingBoxf3 bbox = child_cube_bbox(*current_cube, current_bbox, i);
+        Vec3d child_center = current_cube->center + (child_centers[i] * (this->cubes_properties[depth].edge_length / 2.));
         //if (dist2_to_triangle(a, b, c, child_center) < r2_cube) {
         // dist2_to_triangle and r2_cube are commented out too.
         if (triangle_AABB_intersects(a, b, c, bbox)) {
             if (! current_cube->children[i])
-                current_cube->children[i] = this->pool.construct(child_center);
+                current_cube->children[i] = pool.construct(child_center);
             if (depth > 0)
-                this->insert_triangle(a, b, c, current_cube->children[i], bbox, depth);
+                this->insert_triangle(a, b, c, current_cube->children[i], bbox, depth, pool);
         }
     }
 }
@@ -60,7 +60,12 @@ FillAdaptive::OctreePtr         build_octree(
     const std::vector<Vec3d>    &overhang_triangles, 
     coordf_t                     line_spacing, 
     // If true, octree is densified below internal overhangs only.
-    bool                         support_overhangs_only);
+    bool                         support_overhangs_only,
+    // Octree built before. Returned if it was built from the same mesh, overhang triangles and parameters.
+    OctreePtr                  &&previous = OctreePtr());
+
+// Depths and centers of the cubes of the octree in depth first order, for unit tests to compare octrees.
+std::vector<std::pair<int, Vec3d>> octree_cubes(const Octree &octree);
 
 //
 // Some of the algorithms used by class FillAdaptive were inspired by
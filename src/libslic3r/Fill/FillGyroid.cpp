@@ -112,6 +112,8 @@ static std::vector<Vec2d> make_one_period(double width, double scaleFactor, doub
     return points;
 }
 
+// The waves are generated for each island and each layer. Caching them per phase of z does not pay off,
+// the phase practically never repeats across layers and generating the waves is cheap compared to clipping them.
 static Polylines make_gyroid_waves(double gridZ, double density_adjusted, double line_spacing, double width, double height)
 {
     const double scaleFactor = scale_(line_spacing) / density_adjusted;
@@ -7,7 +7,13 @@
 #include <cmath>
 #include <utility>
 #include <cassert>
+#include <optional>
 
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/task_arena.h>
+
+#include "DistanceField.hpp"
 #include "TreeNode.hpp"
 #include "../../ClipperUtils.hpp"
 #include "../../Layer.hpp"
@@ -62,33 +68,44 @@ Generator::Generator(const PrintObject &print_object, const coordf_t fill_densit
     m_prune_length                                    = coord_t(layer_thickness * std::tan(lightning_infill_prune_angle));
     m_straightening_max_distance                      = coord_t(layer_thickness * std::tan(lightning_infill_straightening_angle));
 
-    generateInitialInternalOverhangs(print_object, throw_on_cancel_callback);
-    generateTrees(print_object, throw_on_cancel_callback);
+    std::vector<Polygons> infill_outlines = collectInfillOutlines(print_object, throw_on_cancel_callback);
+    generateInitialInternalOverhangs(infill_outlines, throw_on_cancel_callback);
+    generateTrees(infill_outlines, throw_on_cancel_callback);
 }
 
-void Generator::generateInitialInternalOverhangs(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback)
+std::vector<Polygons> Generator::collectInfillOutlines(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback)
 {
-    m_overhang_per_layer.resize(print_object.layers().size());
+    std::vector<Polygons> infill_outlines(print_object.layers().size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, print_object.layers().size()), [&print_object, &infill_outlines, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+        for (size_t layer_id = range.begin(); layer_id < range.end(); ++ layer_id) {
+            throw_on_cancel_callback();
+            Polygons infill_area;
+            for (const LayerRegion *layerm : print_object.get_layer(int(layer_id))->regions())
+                for (const Surface &surface : layerm->fill_surfaces())
+                    if (surface.surface_type == stInternal || surface.surface_type == stInternalVoid)
+                        append(infill_area, to_polygons(surface.expolygon));
+            infill_outlines[layer_id] = union_(infill_area);
+        }
+    });
+    return infill_outlines;
+}
 
-    Polygons infill_area_above;
-    // Iterate from top to bottom, to subtract the overhang areas above from the overhang areas on the layer below, to get only overhang in the top layer where it is overhanging.
-    for (int layer_nr = int(print_object.layers().size()) - 1; layer_nr >= 0; --layer_nr) {
-        throw_on_cancel_callback();
-        Polygons infill_area_here;
-        for (const LayerRegion* layerm : print_object.get_layer(layer_nr)->regions())
-            for (const Surface& surface : layerm->fill_surfaces())
-                if (surface.surface_type == stInternal || surface.surface_type == stInternalVoid)
-                    append(infill_area_here, to_polygons(surface.expolygon));
-
-        infill_area_here = union_(infill_area_here);
-        // Remove the part of the infill area that is already supported by the walls.
-        Polygons overhang = diff(offset(infill_area_here, -float(m_wall_supporting_radius)), infill_area_above);
-        // Filter out unprintable polygons and near degenerated polygons (three almost collinear points and so).
-        overhang = opening(overhang, float(SCALED_EPSILON), float(SCALED_EPSILON));
-
-        m_overhang_per_layer[layer_nr] = overhang;
-        infill_area_above = std::move(infill_area_here);
-    }
+void Generator::generateInitialInternalOverhangs(const std::vector<Polygons> &infill_outlines, const std::function<void()> &throw_on_cancel_callback)
+{
+    m_overhang_per_layer.assign(infill_outlines.size(), Polygons());
+
+    // Subtract the infill area above from the infill area of each layer to get only overhang in the top layer where it is overhanging.
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, infill_outlines.size()), [this, &infill_outlines, &throw_on_cancel_callback](const tbb::blocked_range<size_t> &range) {
+        for (size_t layer_nr = range.begin(); layer_nr < range.end(); ++ layer_nr) {
+            throw_on_cancel_callback();
+            const Polygons &infill_area_here  = infill_outlines[layer_nr];
+            const Polygons &infill_area_above = layer_nr + 1 < infill_outlines.size() ? infill_outlines[layer_nr + 1] : Polygons();
+            // Remove the part of the infill area that is already supported by the walls.
+            Polygons overhang = diff(offset(infill_area_here, -float(m_wall_supporting_radius)), infill_area_above);
+            // Filter out unprintable polygons and near degenerated polygons (three almost collinear points and so).
+            m_overhang_per_layer[layer_nr] = opening(overhang, float(SCALED_EPSILON), float(SCALED_EPSILON));
+        }
+    });
 }
 
 const Layer& Generator::getTreesForLayer(const size_t& layer_id) const
@@ -97,59 +114,81 @@ const Layer& Generator::getTreesForLayer(const size_t& layer_id) const
     return m_lightning_layers[layer_id];
 }
 
-void Generator::generateTrees(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback)
+void Generator::generateTrees(const std::vector<Polygons> &infill_outlines, const std::function<void()> &throw_on_cancel_callback)
 {
-    m_lightning_layers.resize(print_object.layers().size());
-
-    std::vector<Polygons> infill_outlines(print_object.layers().size(), Polygons());
-
-    // For-each layer from top to bottom:
-    for (int layer_id = int(print_object.layers().size()) - 1; layer_id >= 0; layer_id--) {
-        throw_on_cancel_callback();
-        for (const LayerRegion *layerm : print_object.get_layer(layer_id)->regions())
-            for (const Surface &surface : layerm->fill_surfaces())
-                if (surface.surface_type == stInternal || surface.surface_type == stInternalVoid)
-                    append(infill_outlines[layer_id], to_polygons(surface.expolygon));
-
-        infill_outlines[layer_id] = union_(infill_outlines[layer_id]);
-    }
-
-    // For various operations its beneficial to quickly locate nearby features on the polygon:
-    const size_t top_layer_id = print_object.layers().size() - 1;
-    EdgeGrid::Grid outlines_locator(get_extents(infill_outlines[top_layer_id]).inflated(SCALED_EPSILON));
-    outlines_locator.create(infill_outlines[top_layer_id], locator_cell_size);
+    const size_t num_layers = infill_outlines.size();
+    m_lightning_layers.resize(num_layers);
+    if (num_layers == 0)
+        return;
+
+    std::vector<BoundingBox> outlines_bboxes(num_layers);
+    for (size_t layer_id = 0; layer_id < num_layers; ++ layer_id)
+        outlines_bboxes[layer_id] = get_extents(infill_outlines[layer_id]);
+
+    // For various operations its beneficial to quickly locate nearby features on the polygon.
+    // Distance fields and outline locators depend on a single layer only. They are created in parallel for a batch of layers
+    // ahead of the propagation of the trees, which has to proceed serially from top to bottom. Each outline locator covers
+    // the bounding box of its own layer, it is extended only if the trees propagated from the layer above reach out of it.
+    const int                                 batch_size = std::max(8, 2 * tbb::this_task_arena::max_concurrency());
+    std::vector<std::optional<DistanceField>> distance_fields(num_layers);
+    std::vector<EdgeGrid::Grid>               outlines_locators(num_layers);
+    // Lowest layer with its distance field and outline locator created.
+    int                                       prepared_layer_id = int(num_layers);
+    auto prepare_layers = [&](int layer_id) {
+        if (layer_id >= prepared_layer_id)
+            return;
+        const int batch_begin = std::max(0, prepared_layer_id - batch_size);
+        tbb::parallel_for(tbb::blocked_range<int>(batch_begin, prepared_layer_id), [&](const tbb::blocked_range<int> &range) {
+            for (int i = range.begin(); i < range.end(); ++ i) {
+                throw_on_cancel_callback();
+                distance_fields[i].emplace(m_supporting_radius, infill_outlines[i], outlines_bboxes[i], m_overhang_per_layer[i]);
+                const BoundingBox &bbox = outlines_bboxes[i];
+                outlines_locators[i].set_bbox(bbox.defined ? bbox.inflated(SCALED_EPSILON) : bbox);
+                outlines_locators[i].create(infill_outlines[i], locator_cell_size);
+            }
+        });
+        prepared_layer_id = batch_begin;
+    };
 
     // For-each layer from top to bottom:
-    for (int layer_id = int(top_layer_id); layer_id >= 0; layer_id--) {
+    // This loop is serial, each layer reconnects the trees propagated from the layer above. Only the per layer data
+    // prepared above is created in parallel, thus the generation of the trees does not scale with the number of cores.
+    for (int layer_id = int(num_layers) - 1; layer_id >= 0; layer_id--) {
         throw_on_cancel_callback();
+        prepare_layers(layer_id);
         Layer             &current_lightning_layer = m_lightning_layers[layer_id];
         const Polygons    &current_outlines        = infill_outlines[layer_id];
-        const BoundingBox &current_outlines_bbox   = get_extents(current_outlines);
+        const BoundingBox &current_outlines_bbox   = outlines_bboxes[layer_id];
+        EdgeGrid::Grid    &outlines_locator        = outlines_locators[layer_id];
 
         // register all trees propagated from the previous layer as to-be-reconnected
         std::vector<NodeSPtr> to_be_reconnected_tree_roots = current_lightning_layer.tree_roots;
 
-        current_lightning_layer.generateNewTrees(m_overhang_per_layer[layer_id], current_outlines, current_outlines_bbox, outlines_locator, m_supporting_radius, m_wall_supporting_radius, throw_on_cancel_callback);
+        current_lightning_layer.generateNewTrees(*distance_fields[layer_id], current_outlines, current_outlines_bbox, outlines_locator, m_supporting_radius, m_wall_supporting_radius, throw_on_cancel_callback);
+        distance_fields[layer_id].reset();
         current_lightning_layer.reconnectRoots(to_be_reconnected_tree_roots, current_outlines, current_outlines_bbox, outlines_locator, m_supporting_radius, m_wall_supporting_radius);
+        // Release the outline locator of this layer, it was already used for propagating the trees from the layer above.
+        outlines_locator = EdgeGrid::Grid();
 
         // Initialize trees for next lower layer from the current one.
         if (layer_id == 0)
             return;
 
-        const Polygons &below_outlines      = infill_outlines[layer_id - 1];
-        BoundingBox     below_outlines_bbox = get_extents(below_outlines).inflated(SCALED_EPSILON);
-        if (const BoundingBox &outlines_locator_bbox = outlines_locator.bbox(); outlines_locator_bbox.defined)
-            below_outlines_bbox.merge(outlines_locator_bbox);
-
-        if (!current_lightning_layer.tree_roots.empty())
-            below_outlines_bbox.merge(get_extents(current_lightning_layer.tree_roots).inflated(SCALED_EPSILON));
-
-        outlines_locator.set_bbox(below_outlines_bbox);
-        outlines_locator.create(below_outlines, locator_cell_size);
+        prepare_layers(layer_id - 1);
+        const Polygons &below_outlines = infill_outlines[layer_id - 1];
+        EdgeGrid::Grid &below_locator  = outlines_locators[layer_id - 1];
+        if (! current_lightning_layer.tree_roots.empty()) {
+            if (BoundingBox trees_bbox = get_extents(current_lightning_layer.tree_roots).inflated(SCALED_EPSILON); ! below_locator.bbox().contains(trees_bbox)) {
+                // The trees of the layer above may reach out of the infill areas of this layer, recreate the locator to cover them.
+                trees_bbox.merge(below_locator.bbox());
+                below_locator = EdgeGrid::Grid(trees_bbox);
+                below_locator.create(below_outlines, locator_cell_size);
+            }
+        }
 
         std::vector<NodeSPtr>& lower_trees = m_lightning_layers[layer_id - 1].tree_roots;
         for (auto& tree : current_lightning_layer.tree_roots)
-            tree->propagateToNextLayer(lower_trees, below_outlines, outlines_locator, m_prune_length, m_straightening_max_distance, locator_cell_size / 2);
+            tree->propagateToNextLayer(lower_trees, below_outlines, below_locator, m_prune_length, m_straightening_max_distance, locator_cell_size / 2);
     }
 }
 
@@ -72,12 +72,23 @@ protected:
      * only when support is generated. For this pattern, we also need to
      * generate overhang areas for the inside of the model.
      */
-    void generateInitialInternalOverhangs(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback);
+    void generateInitialInternalOverhangs(const std::vector<Polygons> &infill_outlines, const std::function<void()> &throw_on_cancel_callback);
+
+    /*!
+     * Collect the sparse infill areas of all layers, in parallel.
+     */
+    static std::vector<Polygons> collectInfillOutlines(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback);
 
     /*!
      * Calculate the tree structure of all layers.
+     *
+     * The distance fields and outline locators of the layers are created
+     * in parallel ahead of the propagation of the trees from top to bottom.
+     * The propagation itself stays serial, as each layer grows the trees
+     * propagated from the layer above, thus its run time remains proportional
+     * to the number of layers rather than to the number of layers per core.
      */
-    void generateTrees(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback);
+    void generateTrees(const std::vector<Polygons> &infill_outlines, const std::function<void()> &throw_on_cancel_callback);
 
     float m_infill_extrusion_width;
 
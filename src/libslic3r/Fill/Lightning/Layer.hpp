@@ -22,6 +22,7 @@ namespace Slic3r::FillLightning
 {
 
 class Node;
+class DistanceField;
 
 using NodeSPtr = std::shared_ptr<Node>;
 using SparseNodeGrid = std::unordered_multimap<Point, std::weak_ptr<Node>, PointHash>;
@@ -43,9 +44,12 @@ class Layer
 public:
     std::vector<NodeSPtr> tree_roots;
 
+    /*!
+     * \param distance_field Distance field of the overhang of this layer, updated with the new trees.
+     */
     void generateNewTrees
     (
-        const Polygons& current_overhang,
+        DistanceField& distance_field,
         const Polygons& current_outlines,
         const BoundingBox& current_outlines_bbox,
         const EdgeGrid::Grid& outline_locator,
@@ -69,6 +69,7 @@
 #include "SVG.hpp"
 
 #include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
 
 // Intel redesigned some TBB interface considerably when merging TBB with their oneAPI set of libraries, see GH #7332.
 // We are using quite an old TBB 2017 U7. Before we update our build servers, let's use the old API, which is deprecated in up to date TBB.
@@ -617,6 +618,12 @@ void GCodeGenerator::do_export(Print* print, const char* path, GCodeProcessorRes
 
     m_processor.initialize(path_tmp);
     m_processor.set_print(print);
+    // Nobody is interested in the moves if the result is not returned.
+    m_processor.enable_streaming(result == nullptr && print->gcode_streaming_enabled());
+    // Keep the moves compacted while processing if they are handed over to the caller (G-code preview).
+    m_processor.enable_compact_moves(result != nullptr);
+    // In single pass mode the G-code processor reserves space for the print time estimates, which are filled in place.
+    m_processor.enable_single_pass(print->gcode_single_pass_enabled());
     m_processor.get_binary_data() = bgcode::binarize::BinaryData();
     GCodeOutputStream file(boost::nowide::fopen(path_tmp.c_str(), "wb"), m_processor);
     if (! file.is_open())
@@ -1034,10 +1041,6 @@ void GCodeGenerator::_do_export(Print& print, GCodeOutputStream &file, Thumbnail
         m_pressure_equalizer = make_unique<PressureEqualizer>(print.config());
     m_enable_extrusion_role_markers = (bool)m_pressure_equalizer;
 
-    if (print.config().avoid_crossing_curled_overhangs){
-        this->m_avoid_crossing_curled_overhangs.init_bed_shape(get_bed_shape(print.config()));
-    }
-
     if (!export_to_binary_gcode) {
         // Write information on the generator.
         file.write_format("; %s\n", Slic3r::header_slic3r_generated().c_str());
@@ -1517,6 +1520,22 @@ void GCodeGenerator::smooth_path_interpolate(
         out.interpolate_add(layer->support_fills, params);
 }
 
+// Maximum number of layers being processed by the G-code export pipeline at the same time.
+// This is the look-ahead window of the parallel preprocessing stage (smooth path interpolation, travel obstacles),
+// thus it bounds the memory held by the prepared, but not yet exported layers.
+// May be overridden by the SLIC3R_GCODE_LAYERS_IN_FLIGHT environment variable.
+static size_t max_layers_in_flight()
+{
+    if (const char *value = boost::nowide::getenv("SLIC3R_GCODE_LAYERS_IN_FLIGHT"); value) {
+        const int layers = atoi(value);
+        if (layers > 0)
+            return size_t(layers);
+        BOOST_LOG_TRIVIAL(error) << "Value in SLIC3R_GCODE_LAYERS_IN_FLIGHT env variable is invalid, using the default.";
+    }
+    // Keep all the worker threads busy with the look-ahead, but never go below the original limit of 12 layers.
+    return std::max<size_t>(12, 2 * size_t(tbb::this_task_arena::max_concurrency()));
+}
+
 // Process all layers of all objects (non-sequential mode) with a parallel pipeline:
 // Generate G-code, run the filters (vase mode, cooling buffer), run the G-code analyser
 // and export G-code into file.
@@ -1530,30 +1549,38 @@ void GCodeGenerator::process_layers(
 {
     size_t layer_to_print_idx = 0;
     const GCode::SmoothPathCache::InterpolationParameters interpolation_params = interpolation_parameters(print.config());
-    const auto smooth_path_interpolator = tbb::make_filter<void, std::pair<size_t, GCode::SmoothPathCache>>(slic3r_tbb_filtermode::serial_in_order,
-        [this, &print, &layers_to_print, &layer_to_print_idx, &interpolation_params](tbb::flow_control &fc) -> std::pair<size_t, GCode::SmoothPathCache> {
-            if (layer_to_print_idx >= layers_to_print.size()) {
-                if (layer_to_print_idx == layers_to_print.size() + (m_pressure_equalizer ? 1 : 0)) {
-                    fc.stop();
-                    return {};
-                } else {
-                    // Pressure equalizer need insert empty input. Because it returns one layer back.
-                    // Insert NOP (no operation) layer;
-                    return { layer_to_print_idx ++, {} };
-                }
-            } else {
+    const auto layer_index_generator = tbb::make_filter<void, size_t>(slic3r_tbb_filtermode::serial_in_order,
+        [this, &print, &layers_to_print, &layer_to_print_idx](tbb::flow_control &fc) -> size_t {
+            // Pressure equalizer need insert empty input. Because it returns one layer back.
+            // Index equal to layers_to_print.size() produces a NOP (no operation) layer.
+            if (layer_to_print_idx == layers_to_print.size() + (m_pressure_equalizer ? 1 : 0)) {
+                fc.stop();
+                return 0;
+            }
+            print.throw_if_canceled();
+            return layer_to_print_idx ++;
+        });
+    // Work, which does not depend on the state carried over between layers by the G-code generator,
+    // is performed in parallel for the layers in flight: Arc fitting / decimation of the extrusion paths,
+    // sorting of the object instances, building of the travel obstacles and rasterization of the curled overhangs.
+    const auto preprocessor = tbb::make_filter<size_t, LayerPreprocessed>(slic3r_tbb_filtermode::parallel,
+        [&print, &tool_ordering, &print_object_instances_ordering, &layers_to_print, &interpolation_params,
+         prepare_avoid_crossing_perimeters = m_prepare_avoid_crossing_perimeters](size_t idx) -> LayerPreprocessed {
+            LayerPreprocessed out;
+            out.layer_to_print_idx = idx;
+            if (idx < layers_to_print.size()) {
                 print.throw_if_canceled();
-                size_t idx = layer_to_print_idx ++;
-                GCode::SmoothPathCache smooth_path_cache;
-                for (const ObjectLayerToPrint &l : layers_to_print[idx].second)
-                    GCodeGenerator::smooth_path_interpolate(l, interpolation_params, smooth_path_cache);
-                return { idx, std::move(smooth_path_cache) };
+                const std::pair<coordf_t, ObjectsLayerToPrint> &layer = layers_to_print[idx];
+                for (const ObjectLayerToPrint &l : layer.second)
+                    GCodeGenerator::smooth_path_interpolate(l, interpolation_params, out.smooth_path_cache);
+                GCodeGenerator::preprocess_layer(print, layer.second, tool_ordering.tools_for_layer(layer.first),
+                    &print_object_instances_ordering, size_t(-1), prepare_avoid_crossing_perimeters, out);
             }
+            return out;
         });
-    const auto generator = tbb::make_filter<std::pair<size_t, GCode::SmoothPathCache>, LayerResult>(slic3r_tbb_filtermode::serial_in_order,
-        [this, &print, &tool_ordering, &print_object_instances_ordering, &layers_to_print, &smooth_path_cache_global](
-            std::pair<size_t, GCode::SmoothPathCache> in) -> LayerResult {
-            size_t layer_to_print_idx = in.first;
+    const auto generator = tbb::make_filter<LayerPreprocessed, LayerResult>(slic3r_tbb_filtermode::serial_in_order,
+        [this, &print, &tool_ordering, &layers_to_print, &smooth_path_cache_global](LayerPreprocessed in) -> LayerResult {
+            size_t layer_to_print_idx = in.layer_to_print_idx;
             if (layer_to_print_idx == layers_to_print.size()) {
                 // Pressure equalizer need insert empty input. Because it returns one layer back.
                 // Insert NOP (no operation) layer;
@@ -1565,8 +1592,8 @@ void GCodeGenerator::process_layers(
                     m_wipe_tower->next_layer();
                 print.throw_if_canceled();
                 return this->process_layer(print, layer.second, layer_tools, 
-                    GCode::SmoothPathCaches{ smooth_path_cache_global, in.second }, 
-                    &layer == &layers_to_print.back(), &print_object_instances_ordering, size_t(-1));
+                    GCode::SmoothPathCaches{ smooth_path_cache_global, in.smooth_path_cache }, std::move(in),
+                    &layer == &layers_to_print.back(), size_t(-1));
             }
         });
     // The pipeline is variable: The vase mode filter is optional.
@@ -1597,7 +1624,7 @@ void GCodeGenerator::process_layers(
         [&output_stream](std::string s) { output_stream.write(s); }
     );
 
-    tbb::filter<void, LayerResult> pipeline_to_layerresult = smooth_path_interpolator & generator;
+    tbb::filter<void, LayerResult> pipeline_to_layerresult = layer_index_generator & preprocessor & generator;
     if (m_spiral_vase)
         pipeline_to_layerresult = pipeline_to_layerresult & spiral_vase;
     if (m_pressure_equalizer)
@@ -1612,7 +1639,7 @@ void GCodeGenerator::process_layers(
     TBBLocalesSetter locales_setter;
     // The pipeline elements are joined using const references, thus no copying is performed.
     output_stream.find_replace_supress();
-    tbb::parallel_pipeline(12, pipeline_to_layerresult & pipeline_to_string & output);
+    tbb::parallel_pipeline(max_layers_in_flight(), pipeline_to_layerresult & pipeline_to_string & output);
     output_stream.find_replace_enable();
 }
 
@@ -1629,38 +1656,47 @@ void GCodeGenerator::process_layers(
 {
     size_t layer_to_print_idx = 0;
     const GCode::SmoothPathCache::InterpolationParameters interpolation_params = interpolation_parameters(print.config());
-    const auto smooth_path_interpolator = tbb::make_filter<void, std::pair<size_t, GCode::SmoothPathCache>> (slic3r_tbb_filtermode::serial_in_order,
-        [this, &print, &layers_to_print, &layer_to_print_idx, interpolation_params](tbb::flow_control &fc) -> std::pair<size_t, GCode::SmoothPathCache> {
-            if (layer_to_print_idx >= layers_to_print.size()) {
-                if (layer_to_print_idx == layers_to_print.size() + (m_pressure_equalizer ? 1 : 0)) {
-                    fc.stop();
-                    return {};
-                } else {
-                    // Pressure equalizer need insert empty input. Because it returns one layer back.
-                    // Insert NOP (no operation) layer;
-                    return { layer_to_print_idx ++, {} };
-                }
-            } else {
+    const auto layer_index_generator = tbb::make_filter<void, size_t>(slic3r_tbb_filtermode::serial_in_order,
+        [this, &print, &layers_to_print, &layer_to_print_idx](tbb::flow_control &fc) -> size_t {
+            // Pressure equalizer need insert empty input. Because it returns one layer back.
+            // Index equal to layers_to_print.size() produces a NOP (no operation) layer.
+            if (layer_to_print_idx == layers_to_print.size() + (m_pressure_equalizer ? 1 : 0)) {
+                fc.stop();
+                return 0;
+            }
+            print.throw_if_canceled();
+            return layer_to_print_idx ++;
+        });
+    // Work, which does not depend on the state carried over between layers by the G-code generator,
+    // is performed in parallel for the layers in flight: Arc fitting / decimation of the extrusion paths,
+    // sorting of the object instances, building of the travel obstacles and rasterization of the curled overhangs.
+    const auto preprocessor = tbb::make_filter<size_t, LayerPreprocessed>(slic3r_tbb_filtermode::parallel,
+        [&print, &tool_ordering, &layers_to_print, &interpolation_params, single_object_idx,
+         prepare_avoid_crossing_perimeters = m_prepare_avoid_crossing_perimeters](size_t idx) -> LayerPreprocessed {
+            LayerPreprocessed out;
+            out.layer_to_print_idx = idx;
+            if (idx < layers_to_print.size()) {
                 print.throw_if_canceled();
-                size_t idx = layer_to_print_idx ++;
-                GCode::SmoothPathCache smooth_path_cache;
-                GCodeGenerator::smooth_path_interpolate(layers_to_print[idx], interpolation_params, smooth_path_cache);
-                return { idx, std::move(smooth_path_cache) };
+                const ObjectLayerToPrint &layer = layers_to_print[idx];
+                GCodeGenerator::smooth_path_interpolate(layer, interpolation_params, out.smooth_path_cache);
+                GCodeGenerator::preprocess_layer(print, { layer }, tool_ordering.tools_for_layer(layer.print_z()),
+                    nullptr, single_object_idx, prepare_avoid_crossing_perimeters, out);
             }
+            return out;
         });
-    const auto generator = tbb::make_filter<std::pair<size_t, GCode::SmoothPathCache>, LayerResult>(slic3r_tbb_filtermode::serial_in_order,
-        [this, &print, &tool_ordering, &layers_to_print, &smooth_path_cache_global, single_object_idx](std::pair<size_t, GCode::SmoothPathCache> in) -> LayerResult {
-            size_t layer_to_print_idx = in.first;
+    const auto generator = tbb::make_filter<LayerPreprocessed, LayerResult>(slic3r_tbb_filtermode::serial_in_order,
+        [this, &print, &tool_ordering, &layers_to_print, &smooth_path_cache_global, single_object_idx](LayerPreprocessed in) -> LayerResult {
+            size_t layer_to_print_idx = in.layer_to_print_idx;
             if (layer_to_print_idx == layers_to_print.size()) {
                 // Pressure equalizer need insert empty input. Because it returns one layer back.
                 // Insert NOP (no operation) layer;
                 return LayerResult::make_nop_layer_result();
             } else {
-                ObjectLayerToPrint &layer = layers_to_print[layer_to_print_idx];
+                const ObjectLayerToPrint &layer = layers_to_print[layer_to_print_idx];
                 print.throw_if_canceled();
-                return this->process_layer(print, { std::move(layer) }, tool_ordering.tools_for_layer(layer.print_z()), 
-                    GCode::SmoothPathCaches{ smooth_path_cache_global, in.second }, 
-                    &layer == &layers_to_print.back(), nullptr, single_object_idx);
+                return this->process_layer(print, { layer }, tool_ordering.tools_for_layer(layer.print_z()), 
+                    GCode::SmoothPathCaches{ smooth_path_cache_global, in.smooth_path_cache }, std::move(in),
+                    &layer == &layers_to_print.back(), single_object_idx);
             }
         });
     // The pipeline is variable: The vase mode filter is optional.
@@ -1690,7 +1726,7 @@ void GCodeGenerator::process_layers(
         [&output_stream](std::string s) { output_stream.write(s); }
     );
 
-    tbb::filter<void, LayerResult> pipeline_to_layerresult = smooth_path_interpolator & generator;
+    tbb::filter<void, LayerResult> pipeline_to_layerresult = layer_index_generator & preprocessor & generator;
     if (m_spiral_vase)
         pipeline_to_layerresult = pipeline_to_layerresult & spiral_vase;
     if (m_pressure_equalizer)
@@ -1705,7 +1741,7 @@ void GCodeGenerator::process_layers(
     TBBLocalesSetter locales_setter;
     // The pipeline elements are joined using const references, thus no copying is performed.
     output_stream.find_replace_supress();
-    tbb::parallel_pipeline(12, pipeline_to_layerresult & pipeline_to_string & output);
+    tbb::parallel_pipeline(max_layers_in_flight(), pipeline_to_layerresult & pipeline_to_string & output);
     output_stream.find_replace_enable();
 }
 
@@ -2217,12 +2253,12 @@ namespace Skirt {
 
 } // namespace Skirt
 
-bool GCodeGenerator::line_distancer_is_required(const std::vector<unsigned int>& extruder_ids) {
+bool GCodeGenerator::line_distancer_is_required(const PrintConfig &config, const std::vector<unsigned int>& extruder_ids) {
     for (const unsigned id : extruder_ids) {
-        const double travel_slope{this->m_config.travel_slope.get_at(id)};
+        const double travel_slope{config.travel_slope.get_at(id)};
         if (
-            this->m_config.travel_lift_before_obstacle.get_at(id)
-            && this->m_config.travel_max_lift.get_at(id) > 0
+            config.travel_lift_before_obstacle.get_at(id)
+            && config.travel_max_lift.get_at(id) > 0
             && travel_slope > 0
             && travel_slope < 90
         ) {
@@ -2523,6 +2559,60 @@ std::vector<GCode::ExtrusionOrder::ExtruderExtrusions> GCodeGenerator::get_sorte
 }
 
 
+// Prepare the data of a single print_z, which do not depend on the state of the G-code generator.
+// Called from a parallel stage of process_layers(), thus it must not touch any GCodeGenerator member.
+void GCodeGenerator::preprocess_layer(
+    const Print                             &print,
+    const ObjectsLayerToPrint               &layers,
+    const LayerTools                        &layer_tools,
+    const std::vector<const PrintInstance*> *ordering,
+    const size_t                             single_object_instance_idx,
+    const bool                               prepare_avoid_crossing_perimeters,
+    LayerPreprocessed                       &out)
+{
+    assert(! layers.empty());
+    if (layer_tools.extruders.empty())
+        // Nothing to extrude, process_layer() will return early.
+        return;
+
+    out.instances_to_print = sort_print_object_instances(layers, ordering, single_object_instance_idx);
+
+    // The same layer as selected by process_layer(): The first object layer, or the first support layer.
+    const Layer *layer = nullptr;
+    for (const ObjectLayerToPrint &l : layers)
+        if (l.object_layer) {
+            layer = l.object_layer;
+            break;
+        }
+    if (layer == nullptr)
+        for (const ObjectLayerToPrint &l : layers)
+            if (l.support_layer) {
+                layer = l.support_layer;
+                break;
+            }
+    if (layer != nullptr && layer->lower_layer != nullptr && line_distancer_is_required(print.config(), layer_tools.extruders))
+        out.travel_obstacles = GCode::TravelObstacleTracker::prepare_layer(*layer, layers);
+
+    // Boundaries of the same layer as process_layer() initializes the avoid crossing perimeters with: The layer of the first instance to print.
+    if (prepare_avoid_crossing_perimeters && ! out.instances_to_print.empty() && print.config().avoid_crossing_perimeters)
+        if (const Layer *first_layer = layers[out.instances_to_print.front().object_layer_to_print_id].layer(); first_layer)
+            out.avoid_crossing_perimeters_boundaries = AvoidCrossingPerimeters::prepare_layer(*first_layer);
+
+    if (print.config().avoid_crossing_curled_overhangs) {
+        JPSPathFinder &curled_overhangs = out.curled_overhangs.emplace();
+        curled_overhangs.init_bed_shape(get_bed_shape(print.config()));
+        curled_overhangs.clear();
+        for (const ObjectLayerToPrint &layer_to_print : layers) {
+            if (layer_to_print.object() == nullptr)
+                continue;
+            for (const auto &instance : layer_to_print.object()->instances()) {
+                curled_overhangs.add_obstacles(layer_to_print.object_layer, instance.shift);
+                curled_overhangs.add_obstacles(layer_to_print.support_layer, instance.shift);
+            }
+        }
+    }
+}
+
 // In sequential mode, process_layer is called once per each object and its copy,
 // therefore layers will contain a single entry and single_object_instance_idx will point to the copy of the object.
 // In non-sequential mode, process_layer is called per each print_z height with all object and support layers accumulated.
@@ -2534,9 +2624,8 @@ LayerResult GCodeGenerator::process_layer(
     const ObjectsLayerToPrint           	&layers,
     const LayerTools        		        &layer_tools,
     const GCode::SmoothPathCaches           &smooth_path_caches,
+    LayerPreprocessed                      &&layer_preprocessed,
     const bool                               last_layer,
-    // Pairs of PrintObject index and its instance index.
-    const std::vector<const PrintInstance*> *ordering,
     // If set to size_t(-1), then print all copies of all objects.
     // Otherwise print a single copy of a single object.
     const size_t                     		 single_object_instance_idx)
@@ -2570,7 +2659,7 @@ LayerResult GCodeGenerator::process_layer(
     bool                 first_layer   = layer.id() == 0;
     unsigned int         first_extruder_id = layer_tools.extruders.front();
 
-    const std::vector<InstanceToPrint> instances_to_print{sort_print_object_instances(layers, ordering, single_object_instance_idx)};
+    const std::vector<InstanceToPrint> &instances_to_print = layer_preprocessed.instances_to_print;
 
     // Initialize config with the 1st object to be printed at this layer.
     m_config.apply(layer.object()->config(), true);
@@ -2645,6 +2734,7 @@ LayerResult GCodeGenerator::process_layer(
 
     // Initialize avoid crossing perimeters before a layer change.
     if (!instances_to_print.empty() && print.config().avoid_crossing_perimeters) {
+        m_avoid_crossing_perimeters.set_prepared_layer(std::move(layer_preprocessed.avoid_crossing_perimeters_boundaries));
         const InstanceToPrint instance_to_print{instances_to_print.front()};
         this->m_avoid_crossing_perimeters.init_layer(
             *layers[instance_to_print.object_layer_to_print_id].layer());
@@ -2661,8 +2751,8 @@ LayerResult GCodeGenerator::process_layer(
 
     gcode += this->change_layer(previous_layer_z, print_z, result.spiral_vase_enable, first_point.head<2>(), first_layer); // this will increase m_layer_index
     m_layer = &layer;
-    if (this->line_distancer_is_required(layer_tools.extruders) && this->m_layer != nullptr && this->m_layer->lower_layer != nullptr)
-        m_travel_obstacle_tracker.init_layer(layer, layers);
+    if (layer_preprocessed.travel_obstacles)
+        m_travel_obstacle_tracker.init_layer(std::move(*layer_preprocessed.travel_obstacles));
 
     m_object_layer_over_raft = false;
     if (!first_layer && ! print.config().layer_gcode.value.empty()) {
@@ -2702,17 +2792,8 @@ LayerResult GCodeGenerator::process_layer(
         m_second_layer_things_done = true;
     }
 
-    if (this->config().avoid_crossing_curled_overhangs) {
-        m_avoid_crossing_curled_overhangs.clear();
-        for (const ObjectLayerToPrint &layer_to_print : layers) {
-            if (layer_to_print.object() == nullptr)
-                continue;
-            for (const auto &instance : layer_to_print.object()->instances()) {
-                m_avoid_crossing_curled_overhangs.add_obstacles(layer_to_print.object_layer, instance.shift);
-                m_avoid_crossing_curled_overhangs.add_obstacles(layer_to_print.support_layer, instance.shift);
-            }
-        }
-    }
+    if (layer_preprocessed.curled_overhangs)
+        m_avoid_crossing_curled_overhangs = std::move(*layer_preprocessed.curled_overhangs);
 
     const bool has_custom_gcode_to_emit     = single_object_instance_idx == size_t(-1) && layer_tools.custom_gcode != nullptr;
     const int  extruder_id_for_custom_gcode = int(layer_tools.extruder_needed_for_color_changer) - 1;
@@ -3224,6 +3305,11 @@ bool GCodeGenerator::GCodeOutputStream::is_error() const
 
 void GCodeGenerator::GCodeOutputStream::flush()
 { 
+    if (m_processor.is_single_pass_enabled()) {
+        // writes the last line, if it was not terminated
+        const std::string &out = m_processor.flush_single_pass();
+        fwrite(out.c_str(), 1, out.size(), this->f);
+    }
     ::fflush(this->f);
 }
 
@@ -3240,9 +3326,15 @@ void GCodeGenerator::GCodeOutputStream::write(const char *what)
     if (what != nullptr) {
         //FIXME don't allocate a string, maybe process a batch of lines?
         std::string gcode(m_find_replace ? m_find_replace->process_layer(what) : what);
-        // writes string to file
-        fwrite(gcode.c_str(), 1, gcode.size(), this->f);
-        m_processor.process_buffer(gcode);
+        if (m_processor.is_single_pass_enabled()) {
+            // writes string to file, with placeholders of the print time estimates reserved by the G-code processor
+            const std::string &out = m_processor.process_buffer_single_pass(gcode);
+            fwrite(out.c_str(), 1, out.size(), this->f);
+        } else {
+            // writes string to file
+            fwrite(gcode.c_str(), 1, gcode.size(), this->f);
+            m_processor.process_buffer(gcode);
+        }
     }
 }
 
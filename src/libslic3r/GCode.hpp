@@ -157,6 +157,9 @@ public:
     // inside the generated string and after the G-code export finishes.
     std::string     placeholder_parser_process(const std::string &name, const std::string &templ, unsigned int current_extruder_id, const DynamicConfig *config_override = nullptr);
     bool            enable_cooling_markers() const { return m_enable_cooling_markers; }
+    // Calculate the avoid crossing perimeters boundaries of the layers in flight in parallel with the G-code generator, enabled by default.
+    // If disabled, the boundaries are calculated by the G-code generator. Used by unit tests to compare the travels.
+    void            enable_avoid_crossing_perimeters_preparation(bool enable) { m_prepare_avoid_crossing_perimeters = enable; }
 
     void            set_layer_count(unsigned int value) { m_layer_count = value; }
     void            apply_print_config(const PrintConfig &print_config);
@@ -192,6 +195,7 @@ private:
         bool is_open() const { return f; }
         bool is_error() const;
 
+        // To be called once the G-code is exported, writes the last line held back in single pass mode.
         void flush();
         void close();
 
@@ -240,15 +244,40 @@ private:
         const bool first_layer
     );
 
+    // Data of a single print_z, which depend only on the layers to be printed and on the print configuration,
+    // not on the state carried over from the previous layer by the G-code generator (extruder, position,
+    // retraction, wipe...). They are prepared in parallel by process_layers() ahead of the serial process_layer().
+    struct LayerPreprocessed {
+        size_t                                                      layer_to_print_idx { 0 };
+        GCode::SmoothPathCache                                      smooth_path_cache;
+        std::vector<InstanceToPrint>                                instances_to_print;
+        // Only filled in if travel lift before obstacle is enabled.
+        std::optional<GCode::TravelObstacleTracker::LayerObstacles> travel_obstacles;
+        // Only filled in if avoid crossing perimeters is enabled: Boundaries of the layer process_layer() calls
+        // AvoidCrossingPerimeters::init_layer() with.
+        std::optional<AvoidCrossingPerimeters::LayerBoundaries>     avoid_crossing_perimeters_boundaries;
+        // Only filled in if avoid crossing curled overhangs is enabled: Bed shape and curled lines of all the instances rasterized.
+        std::optional<JPSPathFinder>                                curled_overhangs;
+    };
+    // Thread safe, called from a worker thread of process_layers().
+    static void preprocess_layer(
+        const Print                             &print,
+        const ObjectsLayerToPrint               &layers,
+        const LayerTools                        &layer_tools,
+        const std::vector<const PrintInstance*> *ordering,
+        const size_t                             single_object_instance_idx,
+        const bool                               prepare_avoid_crossing_perimeters,
+        LayerPreprocessed                       &out);
+
     LayerResult process_layer(
         const Print                     &print,
         // Set of object & print layers of the same PrintObject and with the same print_z.
         const ObjectsLayerToPrint       &layers,
         const LayerTools  				&layer_tools,
         const GCode::SmoothPathCaches   &smooth_path_caches,
+        // Instances to print and travel obstacles of this layer, prepared by preprocess_layer().
+        LayerPreprocessed              &&layer_preprocessed,
         const bool                       last_layer,
-		// Pairs of PrintObject index and its instance index.
-		const std::vector<const PrintInstance*> *ordering,
         // If set to size_t(-1), then print all copies of all objects.
         // Otherwise print a single copy of a single object.
         const size_t                     single_object_idx = size_t(-1));
@@ -294,7 +323,7 @@ private:
         GCode::SmoothPath smooth_path, const ExtrusionFlow &extrusion_flow_override
     );
 
-    std::vector<InstanceToPrint> sort_print_object_instances(
+    static std::vector<InstanceToPrint> sort_print_object_instances(
         // Object and Support layers for the current print_z, collected for a single object, or for possibly multiple objects with multiple instances.
         const std::vector<ObjectLayerToPrint>           &layers,
         // Ordering must be defined for normal (non-sequential print).
@@ -364,7 +393,7 @@ private:
     std::string     retract_and_wipe(bool toolchange = false, bool reset_e = true);
     std::string     unretract() { return m_writer.unretract(); }
     std::string     set_extruder(unsigned int extruder_id, double print_z);
-    bool line_distancer_is_required(const std::vector<unsigned int>& extruder_ids);
+    static bool line_distancer_is_required(const PrintConfig &config, const std::vector<unsigned int>& extruder_ids);
 
     Seams::Placer                       m_seam_placer;
 
@@ -414,6 +443,7 @@ private:
     JPSPathFinder                       m_avoid_crossing_curled_overhangs;
     RetractWhenCrossingPerimeters       m_retract_when_crossing_perimeters;
     GCode::TravelObstacleTracker        m_travel_obstacle_tracker;
+    bool                                m_prepare_avoid_crossing_perimeters { true };
     bool                                m_enable_loop_clipping;
     // If enabled, the G-code generator will put following comments at the ends
     // of the G-code lines: _EXTRUDE_SET_SPEED, _WIPE, _BRIDGE_FAN_START, _BRIDGE_FAN_END
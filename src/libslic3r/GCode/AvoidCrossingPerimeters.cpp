@@ -1201,15 +1201,23 @@ Polyline AvoidCrossingPerimeters::travel_to(const GCodeGenerator &gcodegen, cons
     Vec2d startf = start.cast<double>();
     Vec2d endf   = end  .cast<double>();
 
+    static const LayerBoundaries empty_layer {};
+    const LayerBoundaries &layer = m_layer ? *m_layer : empty_layer;
     bool is_support_layer = dynamic_cast<const SupportLayer *>(gcodegen.layer()) != nullptr;
-    if (!use_external && (is_support_layer || (!m_lslices_offset.empty() && !any_expolygon_contains(m_lslices_offset, m_lslices_offset_bboxes, m_grid_lslices_offset, travel)))) {
+    if (!use_external && (is_support_layer || (!layer.lslices_offset.empty() && !any_expolygon_contains(layer.lslices_offset, layer.lslices_offset_bboxes, layer.grid_lslices_offset, travel)))) {
         // Initialize m_internal only when it is necessary.
-        if (m_internal.boundaries.empty())
-            init_boundary(&m_internal, to_polygons(get_boundary(*gcodegen.layer())));
+        if (m_internal == nullptr || m_internal->boundaries.empty()) {
+            if (const LayerBoundaries *prepared = this->find_prepared_layer(*gcodegen.layer()); prepared) {
+                m_internal = &prepared->internal;
+            } else {
+                init_boundary(&m_layer_boundaries.internal, to_polygons(get_boundary(*gcodegen.layer())));
+                m_internal = &m_layer_boundaries.internal;
+            }
+        }
 
         // Trim the travel line by the bounding box.
-        if (!m_internal.boundaries.empty() && Geometry::liang_barsky_line_clipping(startf, endf, m_internal.bbox)) {
-            travel_intersection_count = avoid_perimeters(m_internal, startf.cast<coord_t>(), endf.cast<coord_t>(), *gcodegen.layer(), result_pl);
+        if (!m_internal->boundaries.empty() && Geometry::liang_barsky_line_clipping(startf, endf, m_internal->bbox)) {
+            travel_intersection_count = avoid_perimeters(*m_internal, startf.cast<coord_t>(), endf.cast<coord_t>(), *gcodegen.layer(), result_pl);
             result_pl.points.front()  = start;
             result_pl.points.back()   = end;
         }
@@ -1252,32 +1260,75 @@ Polyline AvoidCrossingPerimeters::travel_to(const GCodeGenerator &gcodegen, cons
     } else if (max_detour_length_exceeded) {
         *could_be_wipe_disabled = false;
     } else
-        *could_be_wipe_disabled = !need_wipe(gcodegen, m_lslices_offset, m_lslices_offset_bboxes, m_grid_lslices_offset, travel, result_pl, travel_intersection_count);
+        *could_be_wipe_disabled = !need_wipe(gcodegen, layer.lslices_offset, layer.lslices_offset_bboxes, layer.grid_lslices_offset, travel, result_pl, travel_intersection_count);
 
     return result_pl;
 }
 
 // ************************************* AvoidCrossingPerimeters::init_layer() *****************************************
 
-void AvoidCrossingPerimeters::init_layer(const Layer &layer)
+static void init_lslices_offset(const Layer &layer, AvoidCrossingPerimeters::LayerBoundaries &out)
 {
-    m_internal.clear();
-    m_external.clear();
-    m_lslices_offset.clear();
-    m_lslices_offset_bboxes.clear();
-
+    out.layer = &layer;
     float perimeter_offset = -get_external_perimeter_width(layer) / float(2.);
-    m_lslices_offset        = offset_ex(layer.lslices, perimeter_offset);
+    out.lslices_offset     = offset_ex(layer.lslices, perimeter_offset);
 
-    m_lslices_offset_bboxes.reserve(m_lslices_offset.size());
-    for (const ExPolygon &ex_poly : m_lslices_offset)
-        m_lslices_offset_bboxes.emplace_back(get_extents(ex_poly));
+    out.lslices_offset_bboxes.clear();
+    out.lslices_offset_bboxes.reserve(out.lslices_offset.size());
+    for (const ExPolygon &ex_poly : out.lslices_offset)
+        out.lslices_offset_bboxes.emplace_back(get_extents(ex_poly));
 
     BoundingBox bbox_slice(get_extents(layer.lslices));
     bbox_slice.offset(SCALED_EPSILON);
 
-    m_grid_lslices_offset.set_bbox(bbox_slice);
-    m_grid_lslices_offset.create(m_lslices_offset, coord_t(scale_(1.)));
+    out.grid_lslices_offset.set_bbox(bbox_slice);
+    out.grid_lslices_offset.create(out.lslices_offset, coord_t(scale_(1.)));
+}
+
+AvoidCrossingPerimeters::LayerBoundaries AvoidCrossingPerimeters::prepare_layer(const Layer &layer)
+{
+    LayerBoundaries out;
+    init_lslices_offset(layer, out);
+    init_boundary(&out.internal, to_polygons(get_boundary(layer)));
+    return out;
+}
+
+AvoidCrossingPerimeters::LayerBoundaries* AvoidCrossingPerimeters::find_prepared_layer(const Layer &layer)
+{
+    return m_prepared_layer && m_prepared_layer->layer == &layer ? &(*m_prepared_layer) : nullptr;
+}
+
+void AvoidCrossingPerimeters::set_prepared_layer(std::optional<LayerBoundaries> &&layer)
+{
+    // The G-code generator may travel before init_layer() is called for the next layer,
+    // thus the boundaries in use are moved out of the prepared layer being released.
+    if (m_prepared_layer) {
+        LayerBoundaries &l = *m_prepared_layer;
+        if (m_internal == &l.internal) {
+            m_layer_boundaries.internal = std::move(l.internal);
+            m_internal = &m_layer_boundaries.internal;
+        }
+        if (m_layer == &l) {
+            m_layer_boundaries.layer                 = l.layer;
+            m_layer_boundaries.lslices_offset        = std::move(l.lslices_offset);
+            m_layer_boundaries.lslices_offset_bboxes = std::move(l.lslices_offset_bboxes);
+            m_layer_boundaries.grid_lslices_offset   = std::move(l.grid_lslices_offset);
+            m_layer = &m_layer_boundaries;
+        }
+    }
+    m_prepared_layer = std::move(layer);
+}
+
+void AvoidCrossingPerimeters::init_layer(const Layer &layer)
+{
+    m_internal = nullptr;
+    m_external.clear();
+    if (const LayerBoundaries *prepared = this->find_prepared_layer(layer); prepared) {
+        m_layer = prepared;
+    } else {
+        init_lslices_offset(layer, m_layer_boundaries);
+        m_layer = &m_layer_boundaries;
+    }
 }
 
 #if 0
@@ -5,6 +5,7 @@
 #ifndef slic3r_AvoidCrossingPerimeters_hpp_
 #define slic3r_AvoidCrossingPerimeters_hpp_
 
+#include <optional>
 #include <vector>
 
 #include "libslic3r/libslic3r.h"
@@ -26,6 +27,11 @@ class Point;
 class AvoidCrossingPerimeters
 {
 public:
+    AvoidCrossingPerimeters() = default;
+    // Not copyable, not movable: m_layer and m_internal may point to m_layer_boundaries.
+    AvoidCrossingPerimeters(const AvoidCrossingPerimeters &) = delete;
+    AvoidCrossingPerimeters& operator=(const AvoidCrossingPerimeters &) = delete;
+
     // Routing around the objects vs. inside a single object.
     void        use_external_mp(bool use = true) { m_use_external_mp = use; };
     bool        used_external_mp_once() { return use_external_mp_once; }
@@ -60,6 +66,30 @@ public:
         }
     };
 
+    // Boundaries of a single layer, which depend just on the layer, not on the state of the G-code generator.
+    // The EdgeGrids reference the polygons stored next to them, thus LayerBoundaries may be moved, but not copied.
+    struct LayerBoundaries {
+        const Layer             *layer { nullptr };
+        // Lslices offseted by half an external perimeter width. Used for detection if line or polyline is inside of any polygon.
+        ExPolygons               lslices_offset;
+        std::vector<BoundingBox> lslices_offset_bboxes;
+        // Used for detection of line or polyline is inside of any polygon.
+        EdgeGrid::Grid           grid_lslices_offset;
+        // Store all needed data for travels inside object
+        Boundary                 internal;
+
+        LayerBoundaries() = default;
+        LayerBoundaries(LayerBoundaries &&) = default;
+        LayerBoundaries& operator=(LayerBoundaries &&) = default;
+        LayerBoundaries(const LayerBoundaries &) = delete;
+        LayerBoundaries& operator=(const LayerBoundaries &) = delete;
+    };
+    // Thread safe, thus the boundaries of the layers ahead may be calculated in parallel with the G-code generator.
+    static LayerBoundaries prepare_layer(const Layer &layer);
+    // Boundaries of the layer the next init_layer() will be called with, calculated by prepare_layer().
+    // init_layer() and travel_to() take the boundaries of this layer instead of calculating them.
+    void        set_prepared_layer(std::optional<LayerBoundaries> &&layer);
+
     // just for the next travel move
     bool           use_external_mp_once { false };
 private:
@@ -68,15 +98,19 @@ private:
     // we enable it by default for the first travel move in print
     bool           m_disabled_once { true };
 
-    // Lslices offseted by half an external perimeter width. Used for detection if line or polyline is inside of any polygon.
-    ExPolygons               m_lslices_offset;
-    std::vector<BoundingBox> m_lslices_offset_bboxes;
-    // Used for detection of line or polyline is inside of any polygon.
-    EdgeGrid::Grid           m_grid_lslices_offset;
-    // Store all needed data for travels inside object
-    Boundary m_internal;
+    // Prepared layer boundaries matching layer, or nullptr.
+    LayerBoundaries*         find_prepared_layer(const Layer &layer);
+
+    std::optional<LayerBoundaries> m_prepared_layer;
+    // Boundaries of layers, which were not prepared in advance.
+    LayerBoundaries          m_layer_boundaries;
+    // Boundaries of the layer passed to init_layer(), pointing either to m_prepared_layer or to m_layer_boundaries.
+    const LayerBoundaries   *m_layer { nullptr };
+    // Store all needed data for travels inside object, pointing either to m_prepared_layer or to m_layer_boundaries.
+    // Initialized lazily by travel_to() with the boundaries of the layer being printed.
+    const Boundary          *m_internal { nullptr };
     // Store all needed data for travels outside object
-    Boundary m_external;
+    Boundary                 m_external;
 };
 
 } // namespace Slic3r
@@ -0,0 +1,86 @@
+#include "BinarizerWorker.hpp"
+
+#include "libslic3r/Exception.hpp"
+#include "libslic3r/Thread.hpp"
+
+namespace Slic3r {
+
+BinarizerWorker::BinarizerWorker(bgcode::binarize::Binarizer &binarizer) :
+    m_append([&binarizer](const std::string &gcode) { return binarizer.append_gcode(gcode) == bgcode::core::EResult::Success; })
+{}
+
+BinarizerWorker::~BinarizerWorker()
+{
+    if (m_thread.joinable()) {
+        // Interrupted by an exception, drop the G-code not appended yet.
+        {
+            std::scoped_lock<std::mutex> lock(m_mutex);
+            m_queue.clear();
+            m_finished = true;
+        }
+        m_cond.notify_all();
+        m_thread.join();
+    }
+}
+
+void BinarizerWorker::push(std::string &&gcode)
+{
+    if (gcode.empty())
+        return;
+    if (! m_thread.joinable())
+        m_thread = create_thread([this]() { this->run(); });
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cond.wait(lock, [this]() { return m_queue.size() < MaxQueued || m_failed; });
+        if (m_failed)
+            throw Slic3r::RuntimeError("Error while sending gcode to the binarizer.");
+        m_queue.emplace_back(std::move(gcode));
+    }
+    m_cond.notify_all();
+}
+
+void BinarizerWorker::finish()
+{
+    if (! m_thread.joinable())
+        return;
+    {
+        std::scoped_lock<std::mutex> lock(m_mutex);
+        m_finished = true;
+    }
+    m_cond.notify_all();
+    m_thread.join();
+    if (m_failed)
+        throw Slic3r::RuntimeError("Error while sending gcode to the binarizer.");
+}
+
+void BinarizerWorker::run()
+{
+    for (;;) {
+        std::string gcode;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cond.wait(lock, [this]() { return ! m_queue.empty() || m_finished; });
+            if (m_queue.empty())
+                return;
+            gcode = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+        m_cond.notify_all();
+        bool success = false;
+        try {
+            success = m_append(gcode);
+        } catch (...) {
+        }
+        if (! success) {
+            {
+                std::scoped_lock<std::mutex> lock(m_mutex);
+                m_failed = true;
+                m_queue.clear();
+            }
+            m_cond.notify_all();
+            return;
+        }
+    }
+}
+
+} // namespace Slic3r
@@ -0,0 +1,54 @@
+#ifndef slic3r_GCode_BinarizerWorker_hpp_
+#define slic3r_GCode_BinarizerWorker_hpp_
+
+#include <LibBGCode/binarize/binarize.hpp>
+
+#include <boost/thread/thread.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+
+namespace Slic3r {
+
+// Feeds the G-code binarizer from a worker thread, so that the compression of the binary G-code blocks
+// runs in parallel with the processing of the G-code lines by GCodeProcessor::post_process().
+// The G-code is appended to the binarizer in the order it is pushed.
+class BinarizerWorker
+{
+public:
+    // Appends a chunk of G-code, returns false on error.
+    using AppendFn = std::function<bool(const std::string &gcode)>;
+
+    explicit BinarizerWorker(bgcode::binarize::Binarizer &binarizer);
+    explicit BinarizerWorker(AppendFn append) : m_append(std::move(append)) {}
+    // If not finished, drops the G-code not appended yet, for example if the export was canceled.
+    ~BinarizerWorker();
+
+    // Blocks if too much G-code is waiting for the binarizer.
+    // Throws Slic3r::RuntimeError if appending the G-code pushed before failed.
+    void push(std::string &&gcode);
+    // Waits until all the G-code pushed is appended to the binarizer.
+    // Throws Slic3r::RuntimeError if appending the G-code failed.
+    void finish();
+
+private:
+    void run();
+
+    // ExportLines pushes chunks of about 64kB.
+    static constexpr const size_t MaxQueued = 16;
+
+    AppendFn                     m_append;
+    boost::thread                m_thread;
+    std::mutex                   m_mutex;
+    std::condition_variable      m_cond;
+    std::deque<std::string>      m_queue;
+    bool                         m_finished{ false };
+    bool                         m_failed{ false };
+};
+
+} // namespace Slic3r
+
+#endif // slic3r_GCode_BinarizerWorker_hpp_
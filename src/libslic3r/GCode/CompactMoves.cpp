@@ -0,0 +1,285 @@
+#include "CompactMoves.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace Slic3r {
+
+// Quantization of the positions: 1 um, which is the resolution of the G-code export.
+static constexpr float position_scale = 1000.f;
+
+static inline int32_t quantize(float v) { return int32_t(std::lround(v * position_scale)); }
+static inline float   unquantize(int32_t v) { return float(v) / position_scale; }
+
+static inline void append_varint(std::vector<uint8_t> &out, int64_t value)
+{
+    // Zig-zag encoding, so that small negative numbers are encoded with a small number of bytes.
+    uint64_t v = (uint64_t(value) << 1) ^ uint64_t(value >> 63);
+    while (v >= 0x80) {
+        out.emplace_back(uint8_t(v | 0x80));
+        v >>= 7;
+    }
+    out.emplace_back(uint8_t(v));
+}
+
+static inline int64_t read_varint(const std::vector<uint8_t> &in, size_t &offset)
+{
+    uint64_t v     = 0;
+    int      shift = 0;
+    for (;;) {
+        assert(offset < in.size());
+        const uint8_t b = in[offset ++];
+        v |= uint64_t(b & 0x7f) << shift;
+        if ((b & 0x80) == 0)
+            break;
+        shift += 7;
+    }
+    return int64_t(v >> 1) ^ - int64_t(v & 1);
+}
+
+template<typename T>
+size_t CompactMoveVertices::RunColumn<T>::find(size_t idx) const
+{
+    assert(! starts.empty());
+    auto it = std::upper_bound(starts.begin(), starts.end(), uint32_t(idx));
+    assert(it != starts.begin());
+    return size_t(it - starts.begin()) - 1;
+}
+
+CompactMoveVertices::CompactMoveVertices(const std::vector<MoveVertex> &moves, Fields fields) : m_fields(fields)
+{
+    m_key_frames.reserve(moves.size() / KeyFrameInterval + 1);
+    if (m_fields.has(Field::Extrusion))
+        m_delta_extruder.reserve(moves.size());
+    if (m_fields.has(Field::Time))
+        m_time.reserve(moves.size());
+    for (const MoveVertex &move : moves)
+        this->push_back(move);
+    this->shrink_to_fit();
+}
+
+void CompactMoveVertices::clear()
+{
+    m_size = 0;
+    m_deltas.clear();
+    m_key_frames.clear();
+    m_last_gcode_id = 0;
+    m_last_position = Vec3i32::Zero();
+    m_attributes.clear();
+    m_feedrate.clear();
+    m_actual_feedrate.clear();
+    m_width.clear();
+    m_height.clear();
+    m_mm3_per_mm.clear();
+    m_fan_speed.clear();
+    m_temperature.clear();
+    m_delta_extruder.clear();
+    m_time.clear();
+}
+
+void CompactMoveVertices::shrink_to_fit()
+{
+    m_deltas.shrink_to_fit();
+    m_key_frames.shrink_to_fit();
+    m_attributes.shrink_to_fit();
+    m_feedrate.shrink_to_fit();
+    m_actual_feedrate.shrink_to_fit();
+    m_width.shrink_to_fit();
+    m_height.shrink_to_fit();
+    m_mm3_per_mm.shrink_to_fit();
+    m_fan_speed.shrink_to_fit();
+    m_temperature.shrink_to_fit();
+    m_delta_extruder.shrink_to_fit();
+    m_time.shrink_to_fit();
+}
+
+size_t CompactMoveVertices::memory_usage() const
+{
+    return m_deltas.capacity() + m_key_frames.capacity() * sizeof(uint64_t) +
+        m_attributes.memory_usage() + m_feedrate.memory_usage() + m_actual_feedrate.memory_usage() +
+        m_width.memory_usage() + m_height.memory_usage() + m_mm3_per_mm.memory_usage() +
+        m_fan_speed.memory_usage() + m_temperature.memory_usage() +
+        m_delta_extruder.capacity() * sizeof(float) + m_time.capacity() * sizeof(decltype(m_time)::value_type);
+}
+
+void CompactMoveVertices::push_back(const MoveVertex &move)
+{
+    const uint32_t idx = uint32_t(m_size ++);
+    if (idx % KeyFrameInterval == 0) {
+        // Key frame, delta to zero.
+        m_key_frames.emplace_back(m_deltas.size());
+        m_last_gcode_id = 0;
+        m_last_position = Vec3i32::Zero();
+    }
+    const Vec3i32 position{ quantize(move.position.x()), quantize(move.position.y()), quantize(move.position.z()) };
+    append_varint(m_deltas, int64_t(move.gcode_id) - m_last_gcode_id);
+    append_varint(m_deltas, int64_t(position.x()) - int64_t(m_last_position.x()));
+    append_varint(m_deltas, int64_t(position.y()) - int64_t(m_last_position.y()));
+    append_varint(m_deltas, int64_t(position.z()) - int64_t(m_last_position.z()));
+    m_last_gcode_id = move.gcode_id;
+    m_last_position = position;
+
+    m_attributes.push(idx, Attributes{ move.type, move.extrusion_role, move.extruder_id, move.cp_color_id, move.internal_only, move.layer_id });
+    if (m_fields.has(Field::Feedrate)) {
+        m_feedrate.push(idx, move.feedrate);
+        m_actual_feedrate.push(idx, move.actual_feedrate);
+    }
+    if (m_fields.has(Field::Extrusion)) {
+        m_width.push(idx, move.width);
+        m_height.push(idx, move.height);
+        m_mm3_per_mm.push(idx, move.mm3_per_mm);
+        m_delta_extruder.emplace_back(move.delta_extruder);
+    }
+    if (m_fields.has(Field::FanTemperature)) {
+        m_fan_speed.push(idx, move.fan_speed);
+        m_temperature.push(idx, move.temperature);
+    }
+    if (m_fields.has(Field::Time))
+        m_time.emplace_back(move.time);
+}
+
+void CompactMoveVertices::update_gcode_ids(const std::function<unsigned int(unsigned int)> &update)
+{
+    std::vector<uint8_t> deltas;
+    deltas.reserve(m_deltas.size());
+    size_t  offset       = 0;
+    int64_t gcode_id     = 0;
+    int64_t new_gcode_id = 0;
+    for (size_t idx = 0; idx < m_size; ++ idx) {
+        if (idx % KeyFrameInterval == 0) {
+            assert(m_key_frames[idx / KeyFrameInterval] == offset);
+            m_key_frames[idx / KeyFrameInterval] = deltas.size();
+            gcode_id     = 0;
+            new_gcode_id = 0;
+        }
+        gcode_id += read_varint(m_deltas, offset);
+        const int64_t id = int64_t(update((unsigned int)gcode_id));
+        append_varint(deltas, id - new_gcode_id);
+        new_gcode_id = id;
+        // Position deltas are copied unchanged.
+        for (size_t i = 0; i < 3; ++ i)
+            append_varint(deltas, read_varint(m_deltas, offset));
+    }
+    assert(offset == m_deltas.size());
+    m_deltas        = std::move(deltas);
+    m_last_gcode_id = new_gcode_id;
+}
+
+void CompactMoveVertices::fill_runs(size_t idx, const std::vector<size_t> &runs, MoveVertex &out) const
+{
+    const Attributes &attributes = m_attributes.values[runs[rcAttributes]];
+    out.type           = attributes.type;
+    out.extrusion_role = attributes.extrusion_role;
+    out.extruder_id    = attributes.extruder_id;
+    out.cp_color_id    = attributes.cp_color_id;
+    out.internal_only  = attributes.internal_only;
+    out.layer_id       = attributes.layer_id;
+    if (m_fields.has(Field::Feedrate)) {
+        out.feedrate        = m_feedrate.values[runs[rcFeedrate]];
+        out.actual_feedrate = m_actual_feedrate.values[runs[rcActualFeedrate]];
+    }
+    if (m_fields.has(Field::Extrusion)) {
+        out.width          = m_width.values[runs[rcWidth]];
+        out.height         = m_height.values[runs[rcHeight]];
+        out.mm3_per_mm     = m_mm3_per_mm.values[runs[rcMm3PerMm]];
+        out.delta_extruder = m_delta_extruder[idx];
+    }
+    if (m_fields.has(Field::FanTemperature)) {
+        out.fan_speed   = m_fan_speed.values[runs[rcFanSpeed]];
+        out.temperature = m_temperature.values[runs[rcTemperature]];
+    }
+    if (m_fields.has(Field::Time))
+        out.time = m_time[idx];
+}
+
+CompactMoveVertices::MoveVertex CompactMoveVertices::operator[](size_t idx) const
+{
+    assert(idx < m_size);
+    // Decode from the closest key frame.
+    const size_t key_frame = idx / KeyFrameInterval;
+    size_t       offset    = m_key_frames[key_frame];
+    int64_t      gcode_id  = 0;
+    Vec3i32      position  = Vec3i32::Zero();
+    for (size_t i = key_frame * KeyFrameInterval; i <= idx; ++ i) {
+        gcode_id       += read_varint(m_deltas, offset);
+        position.x()   += int32_t(read_varint(m_deltas, offset));
+        position.y()   += int32_t(read_varint(m_deltas, offset));
+        position.z()   += int32_t(read_varint(m_deltas, offset));
+    }
+
+    MoveVertex out;
+    out.gcode_id = (unsigned int)gcode_id;
+    out.position = Vec3f(unquantize(position.x()), unquantize(position.y()), unquantize(position.z()));
+
+    std::vector<size_t> runs(rcCount, 0);
+    runs[rcAttributes] = m_attributes.find(idx);
+    if (m_fields.has(Field::Feedrate)) {
+        runs[rcFeedrate]       = m_feedrate.find(idx);
+        runs[rcActualFeedrate] = m_actual_feedrate.find(idx);
+    }
+    if (m_fields.has(Field::Extrusion)) {
+        runs[rcWidth]      = m_width.find(idx);
+        runs[rcHeight]     = m_height.find(idx);
+        runs[rcMm3PerMm]   = m_mm3_per_mm.find(idx);
+    }
+    if (m_fields.has(Field::FanTemperature)) {
+        runs[rcFanSpeed]    = m_fan_speed.find(idx);
+        runs[rcTemperature] = m_temperature.find(idx);
+    }
+    this->fill_runs(idx, runs, out);
+    return out;
+}
+
+std::vector<CompactMoveVertices::MoveVertex> CompactMoveVertices::expand() const
+{
+    std::vector<MoveVertex> out;
+    out.reserve(m_size);
+    std::copy(this->begin(), this->end(), std::back_inserter(out));
+    return out;
+}
+
+CompactMoveVertices::const_iterator::const_iterator(const CompactMoveVertices &moves, size_t idx) :
+    m_moves(&moves), m_idx(idx), m_runs(rcCount, 0)
+{
+    // Only the begin() or end() iterators are created.
+    assert(idx == 0 || idx == moves.size());
+    this->decode();
+}
+
+void CompactMoveVertices::const_iterator::decode()
+{
+    const CompactMoveVertices &moves = *m_moves;
+    if (m_idx >= moves.size())
+        return;
+
+    if (m_idx % KeyFrameInterval == 0) {
+        m_offset   = moves.m_key_frames[m_idx / KeyFrameInterval];
+        m_gcode_id = 0;
+        m_position = Vec3i32::Zero();
+    }
+    m_gcode_id     += read_varint(moves.m_deltas, m_offset);
+    m_position.x() += int32_t(read_varint(moves.m_deltas, m_offset));
+    m_position.y() += int32_t(read_varint(moves.m_deltas, m_offset));
+    m_position.z() += int32_t(read_varint(moves.m_deltas, m_offset));
+    m_vertex.gcode_id = (unsigned int)m_gcode_id;
+    m_vertex.position = Vec3f(unquantize(m_position.x()), unquantize(m_position.y()), unquantize(m_position.z()));
+
+    m_runs[rcAttributes] = moves.m_attributes.advance(m_runs[rcAttributes], m_idx);
+    if (moves.m_fields.has(Field::Feedrate)) {
+        m_runs[rcFeedrate]       = moves.m_feedrate.advance(m_runs[rcFeedrate], m_idx);
+        m_runs[rcActualFeedrate] = moves.m_actual_feedrate.advance(m_runs[rcActualFeedrate], m_idx);
+    }
+    if (moves.m_fields.has(Field::Extrusion)) {
+        m_runs[rcWidth]    = moves.m_width.advance(m_runs[rcWidth], m_idx);
+        m_runs[rcHeight]   = moves.m_height.advance(m_runs[rcHeight], m_idx);
+        m_runs[rcMm3PerMm] = moves.m_mm3_per_mm.advance(m_runs[rcMm3PerMm], m_idx);
+    }
+    if (moves.m_fields.has(Field::FanTemperature)) {
+        m_runs[rcFanSpeed]    = moves.m_fan_speed.advance(m_runs[rcFanSpeed], m_idx);
+        m_runs[rcTemperature] = moves.m_temperature.advance(m_runs[rcTemperature], m_idx);
+    }
+    moves.fill_runs(m_idx, m_runs, m_vertex);
+}
+
+} // namespace Slic3r
@@ -0,0 +1,183 @@
+#ifndef slic3r_GCode_CompactMoves_hpp_
+#define slic3r_GCode_CompactMoves_hpp_
+
+#include "libslic3r/GCode/GCodeProcessor.hpp"
+#include "libslic3r/enum_bitmask.hpp"
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <vector>
+
+namespace Slic3r {
+
+// Columnar (structure of arrays) storage of GCodeProcessorResult::MoveVertex, trading random access speed for memory.
+// A MoveVertex takes 68 bytes, while a typical move stored here takes about 10 bytes plus the optional fields:
+//  - Positions are quantized to the G-code resolution (1 um) and stored together with the G-code line ids
+//    as variable length deltas to the previous move, with a key frame every KeyFrameInterval moves.
+//  - Values, which change rarely (move type, extrusion role, extruder, color, layer, width, height, feedrate...)
+//    are run length encoded.
+//  - Values, which change with every move (extruded length, time) are only stored if requested.
+// The moves are decoded sequentially by const_iterator in constant time per move, random access
+// by operator[] decodes up to KeyFrameInterval moves.
+class CompactMoveVertices
+{
+public:
+    using MoveVertex = GCodeProcessorResult::MoveVertex;
+
+    // Optional fields of MoveVertex. Fields, which are not requested, are not stored and they read as zeros.
+    enum class Field : unsigned char {
+        // feedrate, actual_feedrate
+        Feedrate,
+        // delta_extruder, width, height, mm3_per_mm
+        Extrusion,
+        // fan_speed, temperature
+        FanTemperature,
+        // time
+        Time,
+    };
+    using Fields = enum_bitmask<Field>;
+    static constexpr Fields all_fields() { return Fields(Field::Feedrate) | Field::Extrusion | Field::FanTemperature | Field::Time; }
+
+    static constexpr size_t KeyFrameInterval = 64;
+
+    CompactMoveVertices() = default;
+    explicit CompactMoveVertices(Fields fields) : m_fields(fields) {}
+    CompactMoveVertices(const std::vector<MoveVertex> &moves, Fields fields);
+
+    Fields      fields() const { return m_fields; }
+    size_t      size() const { return m_size; }
+    bool        empty() const { return m_size == 0; }
+    void        clear();
+    void        shrink_to_fit();
+    // Approximate number of bytes allocated by this container.
+    size_t      memory_usage() const;
+
+    void        push_back(const MoveVertex &move);
+    // Random access, decodes up to KeyFrameInterval moves.
+    MoveVertex  operator[](size_t idx) const;
+    // Replace the G-code line id of each move by update(gcode_id), re-encoding the deltas in a single pass.
+    // update() is called sequentially from the first to the last move.
+    void        update_gcode_ids(const std::function<unsigned int(unsigned int)> &update);
+    // Expand into the array of structures. To be used by code, which has not been adapted yet.
+    std::vector<MoveVertex> expand() const;
+
+    // Sequential decoder. The iterator owns the decoded MoveVertex, thus a reference obtained
+    // by dereferencing the iterator is only valid until the iterator is incremented.
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type        = MoveVertex;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const MoveVertex*;
+        using reference         = const MoveVertex&;
+
+        const_iterator() = default;
+
+        reference        operator*() const { return m_vertex; }
+        pointer          operator->() const { return &m_vertex; }
+        const_iterator&  operator++() { ++ m_idx; this->decode(); return *this; }
+        bool             operator==(const const_iterator &rhs) const { return m_idx == rhs.m_idx; }
+        bool             operator!=(const const_iterator &rhs) const { return m_idx != rhs.m_idx; }
+        size_t           index() const { return m_idx; }
+
+    private:
+        const_iterator(const CompactMoveVertices &moves, size_t idx);
+        void decode();
+
+        const CompactMoveVertices *m_moves { nullptr };
+        size_t                     m_idx { 0 };
+        // Byte offset of the next delta record.
+        size_t                     m_offset { 0 };
+        int64_t                    m_gcode_id { 0 };
+        Vec3i32                    m_position { Vec3i32::Zero() };
+        // Indices of the current runs of the run length encoded columns.
+        std::vector<size_t>        m_runs;
+        MoveVertex                 m_vertex;
+
+        friend class CompactMoveVertices;
+    };
+
+    const_iterator begin() const { return const_iterator(*this, 0); }
+    const_iterator end() const { return const_iterator(*this, m_size); }
+
+private:
+    // Attributes of a move, which change rarely, packed for run length encoding.
+    struct Attributes {
+        EMoveType          type { EMoveType::Noop };
+        GCodeExtrusionRole extrusion_role { GCodeExtrusionRole::None };
+        unsigned char      extruder_id { 0 };
+        unsigned char      cp_color_id { 0 };
+        bool               internal_only { false };
+        unsigned int       layer_id { 0 };
+
+        bool operator==(const Attributes &rhs) const {
+            return type == rhs.type && extrusion_role == rhs.extrusion_role && extruder_id == rhs.extruder_id &&
+                   cp_color_id == rhs.cp_color_id && internal_only == rhs.internal_only && layer_id == rhs.layer_id;
+        }
+    };
+
+    template<typename T>
+    struct RunColumn {
+        // Index of the first move of each run and its value.
+        std::vector<uint32_t> starts;
+        std::vector<T>        values;
+
+        void   push(uint32_t idx, const T &value) {
+            if (values.empty() || ! (values.back() == value)) {
+                starts.emplace_back(idx);
+                values.emplace_back(value);
+            }
+        }
+        // Index of the run containing move idx.
+        size_t find(size_t idx) const;
+        // Advance run index to contain move idx, amortized constant time for sequential access.
+        size_t advance(size_t run, size_t idx) const {
+            while (run + 1 < starts.size() && starts[run + 1] <= idx)
+                ++ run;
+            return run;
+        }
+        void   clear() { starts.clear(); values.clear(); }
+        void   shrink_to_fit() { starts.shrink_to_fit(); values.shrink_to_fit(); }
+        size_t memory_usage() const { return starts.capacity() * sizeof(uint32_t) + values.capacity() * sizeof(T); }
+    };
+
+    // Indices of the run length encoded columns, see const_iterator::m_runs.
+    enum RunColumnIdx : size_t {
+        rcAttributes, rcFeedrate, rcActualFeedrate, rcWidth, rcHeight, rcMm3PerMm, rcFanSpeed, rcTemperature, rcCount
+    };
+
+    void fill_runs(size_t idx, const std::vector<size_t> &runs, MoveVertex &out) const;
+
+    Fields                      m_fields { all_fields() };
+    size_t                      m_size { 0 };
+
+    // Deltas of (gcode_id, x, y, z) to the previous move, zig-zag encoded variable length integers.
+    std::vector<uint8_t>        m_deltas;
+    // Byte offsets into m_deltas of every KeyFrameInterval-th move, which is stored relative to zero.
+    std::vector<uint64_t>       m_key_frames;
+    // Last move stored, to calculate the deltas of push_back().
+    int64_t                     m_last_gcode_id { 0 };
+    Vec3i32                     m_last_position { Vec3i32::Zero() };
+
+    RunColumn<Attributes>       m_attributes;
+    RunColumn<float>            m_feedrate;
+    RunColumn<float>            m_actual_feedrate;
+    RunColumn<float>            m_width;
+    RunColumn<float>            m_height;
+    RunColumn<float>            m_mm3_per_mm;
+    RunColumn<float>            m_fan_speed;
+    RunColumn<float>            m_temperature;
+
+    // Per move values, only stored if requested.
+    std::vector<float>          m_delta_extruder;
+    std::vector<std::array<float, static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count)>> m_time;
+};
+
+ENABLE_ENUM_BITMASK_OPERATORS(CompactMoveVertices::Field)
+
+} // namespace Slic3r
+
+#endif // slic3r_GCode_CompactMoves_hpp_
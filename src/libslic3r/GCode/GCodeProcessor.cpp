@@ -12,6 +12,8 @@
 #include "libslic3r/I18N.hpp"
 #include "libslic3r/Geometry/ArcWelder.hpp"
 #include "GCodeProcessor.hpp"
+#include "BinarizerWorker.hpp"
+#include "CompactMoves.hpp"
 
 #include <boost/algorithm/string/case_conv.hpp>
 #include <boost/log/trivial.hpp>
@@ -68,6 +70,14 @@ const std::vector<std::string> GCodeProcessor::Reserved_Tags = {
 const float GCodeProcessor::Wipe_Width = 0.05f;
 const float GCodeProcessor::Wipe_Height = 0.05f;
 
+static inline void update_wipe_move(GCodeProcessorResult::MoveVertex& move)
+{
+    if (move.type == EMoveType::Wipe) {
+        move.width = GCodeProcessor::Wipe_Width;
+        move.height = GCodeProcessor::Wipe_Height;
+    }
+}
+
 bgcode::binarize::BinarizerConfig GCodeProcessor::s_binarizer_config{
     {
         bgcode::core::ECompressionType::None,            // file metadata
@@ -532,9 +542,15 @@ void GCodeProcessor::UsedFilaments::process_caches(const GCodeProcessor* process
     process_role_cache(processor);
 }
 
+size_t GCodeProcessorResult::moves_count() const
+{
+    return compact_moves ? compact_moves->size() : moves.size();
+}
+
 void GCodeProcessorResult::reset() {
     is_binary_file = false;
     moves.clear();
+    compact_moves.reset();
     lines_ends.clear();
     bed_shape = Pointfs();
     max_print_height = 0.0f;
@@ -573,7 +589,7 @@ bool GCodeProcessor::contains_reserved_tag(const std::string& gcode, std::string
 
     GCodeReader parser;
     parser.parse_buffer(gcode, [&ret, &found_tag](GCodeReader& parser, const GCodeReader::GCodeLine& line) {
-        std::string comment = line.raw();
+        std::string comment(line.raw());
         if (comment.length() > 2 && comment.front() == ';') {
             comment = comment.substr(1);
             for (const std::string& s : Reserved_Tags) {
@@ -600,7 +616,7 @@ bool GCodeProcessor::contains_reserved_tags(const std::string& gcode, unsigned i
 
     GCodeReader parser;
     parser.parse_buffer(gcode, [&ret, &found_tag, max_count](GCodeReader& parser, const GCodeReader::GCodeLine& line) {
-        std::string comment = line.raw();
+        std::string comment(line.raw());
         if (comment.length() > 2 && comment.front() == ';') {
             comment = comment.substr(1);
             for (const std::string& s : Reserved_Tags) {
@@ -1088,10 +1104,16 @@ void GCodeProcessor::reset()
     m_last_default_color_id = 0;
 
     m_options_z_corrector.reset();
+    m_compact_moves.reset();
 
     m_kissslicer_toolchange_time_correction = 0.0f;
 
     m_single_extruder_multi_material = false;
+
+    m_single_pass_placeholders.clear();
+    m_single_pass_file_pos = 0;
+    m_single_pass_next_m73_time = 0.0f;
+    m_single_pass_partial_line.clear();
 }
 
 static inline const char* skip_whitespaces(const char *begin, const char *end) {
@@ -1177,7 +1199,8 @@ void GCodeProcessor::process_ascii_file(const std::string& filename, GCodeReader
     initialize_result_moves();
     size_t parse_line_callback_cntr = 10000;
     m_parser.set_progress_callback(progress_callback);
-    m_parser.parse_file(filename, [this, cancel_callback, &parse_line_callback_cntr](GCodeReader& reader, const GCodeReader::GCodeLine& line) {
+    // The lines are parsed in parallel, the G-code is processed by the callback serially.
+    m_parser.parse_file_parallel(filename, [this, cancel_callback, &parse_line_callback_cntr](GCodeReader& reader, const GCodeReader::GCodeLine& line) {
         if (-- parse_line_callback_cntr == 0) {
             // Don't call the cancel_callback() too often, do it every at every 10000'th line.
             parse_line_callback_cntr = 10000;
@@ -1381,17 +1404,152 @@ void GCodeProcessor::process_buffer(const std::string &buffer)
     });
 }
 
+const std::string& GCodeProcessor::process_buffer_single_pass(const std::string &buffer)
+{
+    assert(is_single_pass_enabled());
+    m_single_pass_buffer.clear();
+    // The buffers are not aligned to the lines. A line is written only after it is complete,
+    // otherwise a line split between two buffers would be written as two lines.
+    const size_t last_line_end = buffer.rfind('\n');
+    if (last_line_end == std::string::npos) {
+        m_single_pass_partial_line += buffer;
+        return m_single_pass_buffer;
+    }
+    if (m_single_pass_partial_line.empty() && last_line_end + 1 == buffer.size())
+        process_lines_single_pass(buffer);
+    else {
+        m_single_pass_partial_line.append(buffer, 0, last_line_end + 1);
+        process_lines_single_pass(m_single_pass_partial_line);
+        m_single_pass_partial_line.assign(buffer, last_line_end + 1, std::string::npos);
+    }
+    return m_single_pass_buffer;
+}
+
+const std::string& GCodeProcessor::flush_single_pass()
+{
+    assert(is_single_pass_enabled());
+    m_single_pass_buffer.clear();
+    if (! m_single_pass_partial_line.empty()) {
+        process_lines_single_pass(m_single_pass_partial_line);
+        m_single_pass_partial_line.clear();
+    }
+    return m_single_pass_buffer;
+}
+
+void GCodeProcessor::process_lines_single_pass(const std::string &lines)
+{
+    m_parser.parse_buffer(lines, [this](GCodeReader&, const GCodeReader::GCodeLine& line) {
+        this->process_gcode_line(line, false);
+        this->write_single_pass_line(line);
+    });
+    if (m_result.lines_ends.empty())
+        m_result.lines_ends.emplace_back(std::vector<size_t>());
+    update_lines_ends_and_out_file_pos(m_single_pass_buffer, m_result.lines_ends.front(), &m_single_pass_file_pos);
+}
+
+// Widths of the lines reserved in single pass mode, including the trailing newline, derived from the longest lines they are filled with.
+// The longest int formatted, including the minus sign.
+static constexpr const size_t SinglePassIntWidth = std::numeric_limits<int>::digits10 + 2;
+// "M73 P100 R<minutes>", the "M73 C<minutes>" line is shorter, the time to a stop shorter than half a minute is formatted as "0.xx".
+static constexpr const size_t SinglePassM73LineWidth = std::string_view("M73 P100 R").size() + SinglePassIntWidth + 1;
+// "; estimated first layer printing time (silent mode) = <days>d 23h 59m 59s", as formatted by get_time_dhms().
+static constexpr const size_t SinglePassTimeLineWidth = std::string_view("; estimated first layer printing time (silent mode) = d 23h 59m 59s").size() + SinglePassIntWidth + 1;
+// " <value>," with the value formatted by "%.2lf", filament statistics up to 10^12 fit.
+static constexpr const size_t SinglePassFilamentValueWidth = std::string_view(" -999999999999.99,").size();
+// Print time between the M73 lines reserved in single pass mode. The total print time is not known while writing, thus the M73 lines
+// cannot be reserved where the percentage or the remaining minutes change, as the rewriting post_process() emits them.
+static constexpr const float SinglePassM73Interval = 60.0f;
+
+static const std::string& single_pass_filament_mask(size_t idx)
+{
+    // Ordered as GCodeProcessor::SinglePassPlaceholder::EType, starting with FilamentUsedMm.
+    static const std::array<const std::string*, 6> masks {
+        &PrintStatistics::FilamentUsedMmMask, &PrintStatistics::FilamentUsedGMask, &PrintStatistics::TotalFilamentUsedGMask,
+        &PrintStatistics::FilamentUsedCm3Mask, &PrintStatistics::FilamentCostMask, &PrintStatistics::TotalFilamentCostMask
+    };
+    return *masks[idx];
+}
+
+static size_t single_pass_filament_line_width(size_t idx, size_t values_count)
+{
+    return single_pass_filament_mask(idx).size() + values_count * SinglePassFilamentValueWidth + 1;
+}
+
+void GCodeProcessor::write_single_pass_line(const GCodeReader::GCodeLine& line)
+{
+    using EType = SinglePassPlaceholder::EType;
+    std::string &out = m_single_pass_buffer;
+    // Reserve empty comment lines to be filled by post_process_single_pass().
+    auto reserve = [this, &out](EType type, size_t lines, size_t width, unsigned int values_count) {
+        m_single_pass_placeholders.push_back({ type, values_count, m_g1_line_id, m_single_pass_file_pos + out.size() });
+        for (size_t i = 0; i < lines; ++ i) {
+            out += ';';
+            out.append(width - 2, ' ');
+            out += '\n';
+        }
+    };
+    size_t machines_enabled = 0;
+    for (const TimeMachine &machine : m_time_processor.machines)
+        if (machine.enabled)
+            ++ machines_enabled;
+
+    // The line of a replaced tag has been counted by process_gcode_line() already,
+    // the additional lines are counted into the ids of the G-code lines the moves refer to.
+    const std::string_view raw = line.raw();
+    if (raw.size() > 1 && raw.front() == ';') {
+        const std::string_view tag = raw.substr(1);
+        if (m_time_processor.export_remaining_time_enabled &&
+            (tag == reserved_tag(ETags::First_Line_M73_Placeholder) || tag == reserved_tag(ETags::Last_Line_M73_Placeholder))) {
+            // Pair <percent, remaining time> per time machine, the first line also with the remaining time to the next printer stop.
+            const bool   first = tag == reserved_tag(ETags::First_Line_M73_Placeholder);
+            const size_t lines = (first ? 2 : 1) * machines_enabled;
+            reserve(first ? EType::FirstLineM73 : EType::LastLineM73, lines, SinglePassM73LineWidth, 0);
+            m_line_id += lines - 1;
+            return;
+        }
+        if (tag == reserved_tag(ETags::Estimated_Printing_Time_Placeholder)) {
+            // Printing time and first layer printing time per time machine, the normal one is always enabled.
+            reserve(EType::EstimatedPrintingTime, 2 * machines_enabled, SinglePassTimeLineWidth, 0);
+            m_line_id += 2 * machines_enabled - 1;
+            return;
+        }
+    }
+    // Prefilter for parsing speed.
+    if (raw.size() >= 8 && raw[0] == ';' && raw[1] == ' ' && (raw[2] == 'f' || raw[2] == 't')) {
+        for (size_t i = 0; i < 6; ++ i)
+            if (boost::algorithm::starts_with(raw, single_pass_filament_mask(i))) {
+                const EType        type         = EType(size_t(EType::FilamentUsedMm) + i);
+                const unsigned int values_count = (type == EType::TotalFilamentUsedG || type == EType::TotalFilamentCost) ? 1 : m_result.extruders_count;
+                reserve(type, 1, single_pass_filament_line_width(i, values_count), values_count);
+                return;
+            }
+    }
+
+    out += raw;
+    out += '\n';
+
+    // Reserve the M73 lines after a G1 line each time the print time calculated so far advances by SinglePassM73Interval.
+    // The print time of the last G1 lines is not calculated yet, thus the M73 lines lag behind by a couple of moves.
+    if (const std::string_view cmd = line.cmd(); m_time_processor.export_remaining_time_enabled &&
+        (cmd == "G0" || cmd == "G1" || cmd == "G2" || cmd == "G3")) {
+        const std::vector<TimeMachine::G1LinesCacheItem> &g1_times_cache =
+            m_time_processor.machines[static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Normal)].g1_times_cache;
+        if (! g1_times_cache.empty() && g1_times_cache.back().elapsed_time >= m_single_pass_next_m73_time) {
+            // Pair <percent, remaining time> and the remaining time to the next printer stop per time machine.
+            reserve(EType::M73, 2 * machines_enabled, SinglePassM73LineWidth, 0);
+            m_line_id += 2 * machines_enabled;
+            m_single_pass_next_m73_time = g1_times_cache.back().elapsed_time + SinglePassM73Interval;
+        }
+    }
+}
+
 void GCodeProcessor::finalize(bool perform_post_process)
 {
     m_result.z_offset = m_z_offset;
 
     // update width/height of wipe moves
-    for (GCodeProcessorResult::MoveVertex& move : m_result.moves) {
-        if (move.type == EMoveType::Wipe) {
-            move.width = Wipe_Width;
-            move.height = Wipe_Height;
-        }
-    }
+    for (GCodeProcessorResult::MoveVertex& move : m_result.moves)
+        update_wipe_move(move);
 
     calculate_time(m_result);
 
@@ -1407,8 +1565,23 @@ void GCodeProcessor::finalize(bool perform_post_process)
 
     update_estimated_statistics();
 
+    if (m_compact_moves_enabled && !m_streaming_enabled) {
+        // Move the remaining moves to the columnar storage, post_process() updates them there.
+        append_compact_moves(m_result.moves.size());
+        m_result.moves = std::vector<GCodeProcessorResult::MoveVertex>();
+    }
+
     if (perform_post_process)
         post_process();
+
+    if (m_streaming_enabled)
+        // Release the memory, the moves were not retained.
+        m_result.moves = std::vector<GCodeProcessorResult::MoveVertex>();
+    else if (m_compact_moves) {
+        // Not set if post_process() re-processed the binarized G-code, which already handed over its moves.
+        m_compact_moves->shrink_to_fit();
+        m_result.compact_moves = std::move(m_compact_moves);
+    }
 }
 
 float GCodeProcessor::get_time(PrintEstimatedStatistics::ETimeMode mode) const
@@ -1835,7 +2008,7 @@ void GCodeProcessor::process_gcode_line(const GCodeReader::GCodeLine& line, bool
         }
     }
     else {
-        const std::string &comment = line.raw();
+        const std::string_view comment = line.raw();
         if (comment.length() > 2 && comment.front() == ';')
             // Process tags embedded into comments. Tag comments always start at the start of a line
             // with a comment and continue with a tag without any whitespace separator.
@@ -3451,9 +3624,9 @@ void GCodeProcessor::process_M108(const GCodeReader::GCodeLine& line)
     if (m_flavor != gcfSailfish)
         return;
 
-    std::string cmd = line.raw();
+    const std::string_view cmd = line.raw();
     size_t pos = cmd.find("T");
-    if (pos != std::string::npos)
+    if (pos != std::string_view::npos)
         process_T(cmd.substr(pos));
 }
 
@@ -3506,9 +3679,9 @@ void GCodeProcessor::process_M135(const GCodeReader::GCodeLine& line)
     if (m_flavor != gcfMakerWare)
         return;
 
-    std::string cmd = line.raw();
+    const std::string_view cmd = line.raw();
     size_t pos = cmd.find("T");
-    if (pos != std::string::npos)
+    if (pos != std::string_view::npos)
         process_T(cmd.substr(pos));
 }
 
@@ -3775,16 +3948,6 @@ void GCodeProcessor::process_T(const std::string_view command)
 
 void GCodeProcessor::post_process()
 {
-    FilePtr in{ boost::nowide::fopen(m_result.filename.c_str(), "rb") };
-    if (in.f == nullptr)
-        throw Slic3r::RuntimeError(std::string("GCode processor post process export failed.\nCannot open file for reading.\n"));
-
-    // temporary file to contain modified gcode
-    std::string out_path = m_result.filename + ".postprocess";
-    FilePtr out{ boost::nowide::fopen(out_path.c_str(), "wb") };
-    if (out.f == nullptr)
-        throw Slic3r::RuntimeError(std::string("GCode processor post process export failed.\nCannot open file for writing.\n"));
-
     std::vector<double> filament_mm(m_result.extruders_count, 0.0);
     std::vector<double> filament_cm3(m_result.extruders_count, 0.0);
     std::vector<double> filament_g(m_result.extruders_count, 0.0);
@@ -3802,6 +3965,21 @@ void GCodeProcessor::post_process()
         filament_total_cost += filament_cost[id];
     }
 
+    if (is_single_pass_enabled()) {
+        post_process_single_pass({ filament_mm, filament_g, { filament_total_g }, filament_cm3, filament_cost, { filament_total_cost } });
+        return;
+    }
+
+    FilePtr in{ boost::nowide::fopen(m_result.filename.c_str(), "rb") };
+    if (in.f == nullptr)
+        throw Slic3r::RuntimeError(std::string("GCode processor post process export failed.\nCannot open file for reading.\n"));
+
+    // temporary file to contain modified gcode
+    std::string out_path = m_result.filename + ".postprocess";
+    FilePtr out{ boost::nowide::fopen(out_path.c_str(), "wb") };
+    if (out.f == nullptr)
+        throw Slic3r::RuntimeError(std::string("GCode processor post process export failed.\nCannot open file for writing.\n"));
+
     double total_g_wipe_tower = m_print->print_statistics().total_wipe_tower_filament_weight;
 
     if (m_binarizer.is_enabled()) {
@@ -3972,14 +4150,15 @@ void GCodeProcessor::post_process()
         size_t m_out_file_pos{ 0 };
 
         bgcode::binarize::Binarizer& m_binarizer;
+        BinarizerWorker m_binarizer_worker;
 
     public:
         ExportLines(bgcode::binarize::Binarizer& binarizer, EWriteType type,
             const std::array<TimeMachine, static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count)>& machines)
 #ifndef NDEBUG
-        : m_statistics(*this), m_binarizer(binarizer), m_write_type(type), m_machines(machines) {}
+        : m_statistics(*this), m_binarizer(binarizer), m_binarizer_worker(binarizer), m_write_type(type), m_machines(machines) {}
 #else
-        : m_binarizer(binarizer), m_write_type(type), m_machines(machines) {}
+        : m_binarizer(binarizer), m_binarizer_worker(binarizer), m_write_type(type), m_machines(machines) {}
 #endif // NDEBUG
 
         // return: number of internal G1 lines (from G2/G3 splitting) processed
@@ -4126,8 +4305,7 @@ void GCodeProcessor::post_process()
             }
 
             if (m_binarizer.is_enabled()) {
-                if (m_binarizer.append_gcode(out_string) != bgcode::core::EResult::Success)
-                    throw Slic3r::RuntimeError("Error while sending gcode to the binarizer.");
+                m_binarizer_worker.push(std::move(out_string));
             }
             else {
                 write_to_file(out, out_string, result, out_path);
@@ -4149,8 +4327,8 @@ void GCodeProcessor::post_process()
 #endif // NDEBUG
 
             if (m_binarizer.is_enabled()) {
-                if (m_binarizer.append_gcode(out_string) != bgcode::core::EResult::Success)
-                    throw Slic3r::RuntimeError("Error while sending gcode to the binarizer.");
+                m_binarizer_worker.push(std::move(out_string));
+                m_binarizer_worker.finish();
             }
             else {
                 write_to_file(out, out_string, result, out_path);
@@ -4169,6 +4347,16 @@ void GCodeProcessor::post_process()
             }
         }
 
+        void synchronize_moves(CompactMoveVertices& moves) const {
+            auto it = m_gcode_lines_map.begin();
+            moves.update_gcode_ids([this, &it](unsigned int gcode_id) {
+                while (it != m_gcode_lines_map.end() && it->first < gcode_id) {
+                    ++it;
+                }
+                return (it != m_gcode_lines_map.end() && it->first == gcode_id) ? static_cast<unsigned int>(it->second) : gcode_id;
+            });
+        }
+
         size_t get_size() const { return m_size; }
 
     private:
@@ -4408,7 +4596,7 @@ void GCodeProcessor::post_process()
                         reader.parse_line(line, [&gline](GCodeReader& reader, const GCodeReader::GCodeLine& l) { gline = l; });
 
                         float val;
-                        if (gline.has_value('T', val) && gline.raw().find("cooldown") != std::string::npos && m_is_XL_printer) {
+                        if (gline.has_value('T', val) && gline.raw().find("cooldown") != std::string_view::npos && m_is_XL_printer) {
                             if (static_cast<int>(val) == tool_number)
                                 return std::string("; removed M104\n");
                         }
@@ -4520,6 +4708,8 @@ void GCodeProcessor::post_process()
         // restore the proper filename
         m_result.filename = result_filename;
     }
+    else if (m_compact_moves)
+        export_lines.synchronize_moves(*m_compact_moves);
     else
         export_lines.synchronize_moves(m_result);
 
@@ -4528,6 +4718,137 @@ void GCodeProcessor::post_process()
             "Is " + out_path + " locked?" + '\n');
 }
 
+void GCodeProcessor::post_process_single_pass(const std::vector<std::vector<double>>& filament_stats)
+{
+    using EType = SinglePassPlaceholder::EType;
+
+    FilePtr out{ boost::nowide::fopen(m_result.filename.c_str(), "r+b") };
+    if (out.f == nullptr)
+        throw Slic3r::RuntimeError(std::string("GCode processor post process export failed.\nCannot open file for writing.\n"));
+
+    auto time_in_minutes = [](float time_in_seconds) {
+        assert(time_in_seconds >= 0.f);
+        return int((time_in_seconds + 0.5f) / 60.0f);
+    };
+
+    // Pad the line to the reserved width, the trailing newline included.
+    auto append_line = [](std::string& text, std::string line, size_t width) {
+        if (! line.empty() && line.back() == '\n')
+            line.pop_back();
+        if (line.size() >= width)
+            throw Slic3r::RuntimeError(std::string("GCode processor post process export failed.\nThe line \"") + line + "\" does not fit into the space reserved for it.\n");
+        line.resize(width - 1, ' ');
+        text += line;
+        text += '\n';
+    };
+
+    auto format_line_M73_main = [](const std::string& mask, int percent, int time) {
+        char line_M73[64];
+        sprintf(line_M73, mask.c_str(), std::to_string(percent).c_str(), std::to_string(time).c_str());
+        return std::string(line_M73);
+    };
+
+    auto format_line_M73_stop = [](const std::string& mask, const std::string& time) {
+        char line_M73[64];
+        sprintf(line_M73, mask.c_str(), time.c_str());
+        return std::string(line_M73);
+    };
+
+    // Elapsed time at the G1 line with the given id, or at the last G1 line before it with a calculated time.
+    auto elapsed_time = [](const TimeMachine& machine, unsigned int g1_line_id) {
+        auto it = std::upper_bound(machine.g1_times_cache.begin(), machine.g1_times_cache.end(), g1_line_id,
+            [](unsigned int value, const TimeMachine::G1LinesCacheItem& item) { return value < item.id; });
+        return it == machine.g1_times_cache.begin() ? 0.0f : std::prev(it)->elapsed_time;
+    };
+
+    // pair <percent, remaining time> and remaining time to next printer stop, the latter is left empty if there is none
+    auto append_lines_M73 = [&](std::string& text, const TimeMachine& machine, float time) {
+        const float total   = float(machine.time);
+        const int   percent = total > 0.0f ? std::min(100, int(100.0f * time / total)) : 100;
+        append_line(text, format_line_M73_main(machine.line_m73_main_mask, percent, time_in_minutes(std::max(0.0f, total - time))), SinglePassM73LineWidth);
+        auto it_stop = std::upper_bound(machine.stop_times.begin(), machine.stop_times.end(), time,
+            [](float value, const TimeMachine::StopTime& t) { return value < t.elapsed_time; });
+        if (it_stop == machine.stop_times.end())
+            append_line(text, ";", SinglePassM73LineWidth);
+        else if (const int to_export_stop = time_in_minutes(it_stop->elapsed_time - time); to_export_stop > 0)
+            append_line(text, format_line_M73_stop(machine.line_m73_stop_mask, std::to_string(to_export_stop)), SinglePassM73LineWidth);
+        else
+            append_line(text, format_line_M73_stop(machine.line_m73_stop_mask,
+                Slic3r::float_to_string_decimal_point((it_stop->elapsed_time - time) / 60.0f, 2)), SinglePassM73LineWidth);
+    };
+
+    size_t      file_pos = 0;
+    std::string text;
+    for (const SinglePassPlaceholder& placeholder : m_single_pass_placeholders) {
+        text.clear();
+        switch (placeholder.type) {
+        case EType::FirstLineM73:
+            for (const TimeMachine& machine : m_time_processor.machines)
+                if (machine.enabled) {
+                    append_line(text, format_line_M73_main(machine.line_m73_main_mask, 0, time_in_minutes(float(machine.time))), SinglePassM73LineWidth);
+                    append_line(text, machine.stop_times.empty() ? std::string(";") :
+                        format_line_M73_stop(machine.line_m73_stop_mask, std::to_string(time_in_minutes(machine.stop_times.front().elapsed_time))),
+                        SinglePassM73LineWidth);
+                }
+            break;
+        case EType::LastLineM73:
+            for (const TimeMachine& machine : m_time_processor.machines)
+                if (machine.enabled)
+                    append_line(text, format_line_M73_main(machine.line_m73_main_mask, 100, 0), SinglePassM73LineWidth);
+            break;
+        case EType::M73:
+            for (const TimeMachine& machine : m_time_processor.machines)
+                if (machine.enabled)
+                    append_lines_M73(text, machine, elapsed_time(machine, placeholder.g1_line_id));
+            break;
+        case EType::EstimatedPrintingTime:
+            for (const bool first_layer : { false, true })
+                for (size_t i = 0; i < static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Count); ++i) {
+                    const TimeMachine& machine = m_time_processor.machines[i];
+                    if (machine.enabled) {
+                        char buf[128];
+                        sprintf(buf, first_layer ? "; estimated first layer printing time (%s mode) = %s" : "; estimated printing time (%s mode) = %s",
+                            (static_cast<PrintEstimatedStatistics::ETimeMode>(i) == PrintEstimatedStatistics::ETimeMode::Normal) ? "normal" : "silent",
+                            get_time_dhms(first_layer ? machine.first_layer_time : machine.time).c_str());
+                        append_line(text, buf, SinglePassTimeLineWidth);
+                    }
+                }
+            break;
+        default:
+        {
+            const size_t               idx    = size_t(placeholder.type) - size_t(EType::FilamentUsedMm);
+            const std::vector<double> &values = filament_stats[idx];
+            const size_t               count  = std::min<size_t>(values.size(), placeholder.values_count);
+            std::string line = single_pass_filament_mask(idx);
+            char buf[64];
+            for (size_t i = 0; i < count; ++i) {
+                snprintf(buf, sizeof(buf), i == count - 1 ? " %.2lf" : " %.2lf,", values[i]);
+                line += buf;
+            }
+            append_line(text, line, single_pass_filament_line_width(idx, placeholder.values_count));
+            break;
+        }
+        }
+
+        // Seek relative to the current position, the absolute position may not fit into the long offset of fseek().
+        assert(placeholder.file_pos >= file_pos);
+        for (size_t distance = placeholder.file_pos - file_pos; distance > 0;) {
+            const size_t step = std::min<size_t>(distance, size_t(1) << 30);
+            if (::fseek(out.f, long(step), SEEK_CUR) != 0)
+                throw Slic3r::RuntimeError(std::string("GCode processor post process export failed.\nError while seeking in file.\n"));
+            distance -= step;
+        }
+        ::fwrite(text.data(), 1, text.size(), out.f);
+        if (::ferror(out.f))
+            throw Slic3r::RuntimeError("GCode processor post process export failed.\nIs the disk full?");
+        file_pos = placeholder.file_pos + text.size();
+    }
+
+    out.close();
+    // Release the memory.
+    m_single_pass_placeholders = std::vector<SinglePassPlaceholder>();
+}
+
 void GCodeProcessor::store_move_vertex(EMoveType type, bool internal_only)
 {
     m_last_line_id = (type == EMoveType::Color_change || type == EMoveType::Pause_Print || type == EMoveType::Custom_GCode) ?
@@ -4736,6 +5057,12 @@ void GCodeProcessor::calculate_time(GCodeProcessorResult& result, size_t keep_la
             actual_speed_moves = std::move(machine.actual_speed_moves);
     }
 
+    if (m_streaming_enabled) {
+        // The actual speed moves are only needed to render the moves, which are not retained.
+        discard_processed_moves();
+        return;
+    }
+
     // insert actual speed moves into the move list. We will do this in two stages (to avoid inserting in the middle of
     // result.moves repeatedly). First, we create individual vectors of MoveVertices, and store them along with their
     // required index in the result.moves vector after they are all inserted. Then we go through the destination
@@ -4804,6 +5131,46 @@ void GCodeProcessor::calculate_time(GCodeProcessorResult& result, size_t keep_la
             block.move_id = (it != id_map.end()) ? it->second : block.move_id + inserted_count;
         }
     }
+
+    if (m_compact_moves_enabled)
+        discard_processed_moves();
+}
+
+void GCodeProcessor::discard_processed_moves()
+{
+    // The move pointed to by OptionsZCorrector is going to be updated.
+    if (m_result.moves.empty() || m_options_z_corrector.is_set())
+        return;
+
+    // Keep the last move, the moves referenced by the time blocks not processed yet and their predecessors.
+    size_t keep_from = m_result.moves.size() - 1;
+    for (const TimeMachine &machine : m_time_processor.machines)
+        for (const TimeBlock &block : machine.blocks)
+            keep_from = std::min<size_t>(keep_from, block.move_id > 0 ? block.move_id - 1 : 0);
+    // Erasing from the front moves the moves kept, thus erase once the processed moves make up at least half of the moves
+    // to keep the cost amortized linear.
+    if (keep_from == 0 || 2 * keep_from < m_result.moves.size())
+        return;
+
+    if (m_compact_moves_enabled && !m_streaming_enabled)
+        append_compact_moves(keep_from);
+    m_result.moves.erase(m_result.moves.begin(), m_result.moves.begin() + keep_from);
+    for (TimeMachine &machine : m_time_processor.machines)
+        for (TimeBlock &block : machine.blocks)
+            block.move_id -= static_cast<unsigned int>(keep_from);
+}
+
+void GCodeProcessor::append_compact_moves(size_t count)
+{
+    assert(count <= m_result.moves.size());
+    if (!m_compact_moves)
+        m_compact_moves = std::make_shared<CompactMoveVertices>(CompactMoveVertices::all_fields());
+    for (size_t i = 0; i < count; ++i) {
+        // The moves leave GCodeProcessorResult::moves before finalize() updates the wipe moves there.
+        GCodeProcessorResult::MoveVertex& move = m_result.moves[i];
+        update_wipe_move(move);
+        m_compact_moves->push_back(move);
+    }
 }
 
 void GCodeProcessor::simulate_st_synchronize(float additional_time)
@@ -17,6 +17,7 @@
 
 #include <cstdint>
 #include <array>
+#include <memory>
 #include <vector>
 #include <string>
 #include <string_view>
@@ -25,6 +26,7 @@
 namespace Slic3r {
 
     class Print;
+    class CompactMoveVertices;
 
     enum class EMoveType : unsigned char
     {
@@ -143,6 +145,9 @@ namespace Slic3r {
         bool is_binary_file;
         unsigned int id;
         std::vector<MoveVertex> moves;
+        // Columnar storage of the moves, see GCodeProcessor::enable_compact_moves().
+        // If set, this->moves is empty.
+        std::shared_ptr<const CompactMoveVertices> compact_moves;
         // Positions of ends of lines of the final G-code this->filename after TimeProcessor::post_process() finalizes the G-code.
         // Binarized gcodes usually have several gcode blocks. Each block has its own list on ends of lines.
         // Ascii gcodes have only one list on ends of lines
@@ -165,6 +170,9 @@ namespace Slic3r {
         ConflictResultOpt conflict_result;
         std::optional<std::pair<std::string, std::string>> sequential_collision_detected;
 
+        // Number of moves, stored either in this->moves or in this->compact_moves.
+        size_t moves_count() const;
+
         void reset();
     };
 
@@ -478,6 +486,8 @@ namespace Slic3r {
                 m_move_id.reset();
                 m_custom_gcode_per_print_z_id.reset();
             }
+
+            bool is_set() const { return m_move_id.has_value(); }
         };
 
         static bgcode::binarize::BinarizerConfig& get_binarizer_config() { return s_binarizer_config; }
@@ -564,6 +574,48 @@ namespace Slic3r {
         UsedFilaments m_used_filaments;
 
         Print* m_print{ nullptr };
+        bool m_compact_moves_enabled{ false };
+        // Moves with their print times calculated, if m_compact_moves_enabled. Handed over to GCodeProcessorResult::compact_moves by finalize().
+        std::shared_ptr<CompactMoveVertices> m_compact_moves;
+        bool m_streaming_enabled{ false };
+        bool m_single_pass_enabled{ false };
+
+        // Space reserved in the output G-code by process_buffer_single_pass(), filled in place by post_process().
+        struct SinglePassPlaceholder
+        {
+            enum class EType : unsigned char
+            {
+                // M73 lines replacing the placeholder tags.
+                FirstLineM73,
+                LastLineM73,
+                // M73 lines inserted after G1 lines.
+                M73,
+                EstimatedPrintingTime,
+                FilamentUsedMm,
+                FilamentUsedG,
+                TotalFilamentUsedG,
+                FilamentUsedCm3,
+                FilamentCost,
+                TotalFilamentCost
+            };
+
+            EType        type;
+            // Number of values of the filament statistics.
+            unsigned int values_count;
+            // Id of the G1 line preceding the M73 lines, their print time is the elapsed time of this line.
+            unsigned int g1_line_id;
+            // Position in the output G-code.
+            size_t       file_pos;
+        };
+        std::vector<SinglePassPlaceholder> m_single_pass_placeholders;
+        // Size of the G-code written in single pass mode.
+        size_t m_single_pass_file_pos{ 0 };
+        // Elapsed print time of the normal mode, at which the next M73 lines are reserved.
+        float m_single_pass_next_m73_time{ 0.0f };
+        // Output of process_buffer_single_pass().
+        std::string m_single_pass_buffer;
+        // Unterminated last line of the buffers passed to process_buffer_single_pass(), to be completed by the next buffer.
+        std::string m_single_pass_partial_line;
 
         GCodeProcessorResult m_result;
         static unsigned int s_result_id;
@@ -581,6 +633,26 @@ namespace Slic3r {
             return m_time_processor.machines[static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Stealth)].enabled;
         }
         void enable_machine_envelope_processing(bool enabled) { m_time_processor.machine_envelope_processing_enabled = enabled; }
+        // Compact moves mode: The moves are appended to a columnar storage as soon as their print times are calculated,
+        // GCodeProcessorResult::moves keeps the moves still referenced by the time estimator, the other moves are released in batches.
+        // finalize() hands the columnar storage over to GCodeProcessorResult::compact_moves, GCodeProcessorResult::moves is empty then.
+        void enable_compact_moves(bool enabled) { m_compact_moves_enabled = enabled; }
+        bool is_compact_moves_enabled() const { return m_compact_moves_enabled; }
+        // Streaming mode: The moves are discarded as soon as their print times are calculated, only the print statistics
+        // and the data needed to post-process the G-code are kept. GCodeProcessorResult::moves is empty after finalize().
+        void enable_streaming(bool enabled) { m_streaming_enabled = enabled; }
+        bool is_streaming_enabled() const { return m_streaming_enabled; }
+        // Single pass mode: The caller writes the G-code returned by process_buffer_single_pass(), which reserves lines of fixed width
+        // for the M73 lines, the print time estimates and the filament statistics. post_process() fills them in place
+        // instead of rewriting the whole file. Not applicable to binary G-code and to M104.1 backtracing, which fall back to
+        // process_buffer() and to the rewriting post_process().
+        // The output differs from the one of the rewriting post_process(): As the total print time is not known while writing,
+        // the M73 lines are reserved after a G1 line each time the print time calculated so far advances by a minute, while
+        // the rewriting post_process() emits them whenever the percentage or the remaining minutes change. The lines filled in
+        // place are padded with trailing spaces to their reserved width, and the lines not needed, for example the remaining
+        // time to the next printer stop after the last stop, are left as comment lines consisting of ';' and spaces.
+        void enable_single_pass(bool enabled) { m_single_pass_enabled = enabled; }
+        bool is_single_pass_enabled() const { return m_single_pass_enabled && ! m_binarizer.is_enabled() && ! m_result.backtrace_enabled; }
         void reset();
 
         const GCodeProcessorResult& get_result() const { return m_result; }
@@ -599,6 +671,10 @@ namespace Slic3r {
             m_result.moves.emplace_back(GCodeProcessorResult::MoveVertex());
         }
         void process_buffer(const std::string& buffer);
+        // Single pass mode: Process the complete lines of the buffer, return the G-code to be written to the output file.
+        const std::string& process_buffer_single_pass(const std::string& buffer);
+        // Single pass mode: Process the last line if it was not terminated, return the G-code to be written to the output file.
+        const std::string& flush_single_pass();
         void finalize(bool post_process);
 
         float get_time(PrintEstimatedStatistics::ETimeMode mode) const;
@@ -750,6 +826,13 @@ namespace Slic3r {
         // 1) add remaining time lines M73 and update moves' gcode ids accordingly
         // 2) update used filament data
         void post_process();
+        // single pass mode: fill in place the space reserved by process_buffer_single_pass(),
+        // filament_stats are indexed by SinglePassPlaceholder::EType, starting with FilamentUsedMm
+        void post_process_single_pass(const std::vector<std::vector<double>>& filament_stats);
+        // single pass mode: process the complete lines, write them with the space reserved after them to m_single_pass_buffer
+        void process_lines_single_pass(const std::string& lines);
+        // single pass mode: write the G-code line and the space reserved after it to m_single_pass_buffer
+        void write_single_pass_line(const GCodeReader::GCodeLine& line);
 
         void store_move_vertex(EMoveType type, bool internal_only = false);
 
@@ -774,6 +857,12 @@ namespace Slic3r {
         void process_filaments(CustomGCode::Type code);
 
         void calculate_time(GCodeProcessorResult& result, size_t keep_last_n_blocks = 0, float additional_time = 0.0f);
+        // Streaming mode: Discard the moves, which are not referenced by the time blocks anymore.
+        // Compact moves mode: Append these moves to m_compact_moves and release them from GCodeProcessorResult::moves.
+        // The moves are released once they make up at least half of GCodeProcessorResult::moves.
+        void discard_processed_moves();
+        // Compact moves mode: Append the first count moves of GCodeProcessorResult::moves to m_compact_moves.
+        void append_compact_moves(size_t count);
 
         // Simulates firmware st_synchronize() call
         void simulate_st_synchronize(float additional_time = 0.0f);
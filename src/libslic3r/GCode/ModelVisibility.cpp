@@ -7,7 +7,7 @@
 
 #include "libslic3r/ShortEdgeCollapse.hpp"
 #include "libslic3r/GCode/ModelVisibility.hpp"
-#include "libslic3r/AABBTreeIndirect.hpp"
+#include "libslic3r/AABBTreeWide.hpp"
 #include "admesh/stl.h"
 #include "libslic3r/TriangleMesh.hpp"
 #include "libslic3r/libslic3r.h"
@@ -95,7 +95,7 @@ Vec3f sample_power_cosine_hemisphere(const Vec2f &samples, float power) {
 }
 
 std::vector<float> raycast_visibility(
-    const AABBTreeIndirect::Tree<3, float> &raycasting_tree,
+    const AABBTreeIndirect::WideTree4f &raycasting_tree,
     const indexed_triangle_set &triangles,
     const TriangleSetSamples &samples,
     size_t negative_volumes_start_index,
@@ -265,7 +265,7 @@ Visibility::Visibility(
 
     BOOST_LOG_TRIVIAL(debug)
     << "SeamPlacer: build AABB tree: start";
-    auto raycasting_tree = AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(triangle_set.vertices,
+    auto raycasting_tree = AABBTreeIndirect::build_wide_aabb_tree_over_indexed_triangle_set<4>(triangle_set.vertices,
             triangle_set.indices);
 
     throw_if_canceled();
@@ -21,10 +21,10 @@ Painting::Painting(const Transform3d &obj_transform, const ModelVolumePtrs &volu
         }
     }
 
-    this->enforcers_tree = AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(
+    this->enforcers_tree = AABBTreeIndirect::build_wide_aabb_tree_over_indexed_triangle_set<4>(
         this->enforcers.vertices, this->enforcers.indices
     );
-    this->blockers_tree = AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(
+    this->blockers_tree = AABBTreeIndirect::build_wide_aabb_tree_over_indexed_triangle_set<4>(
         this->blockers.vertices, this->blockers.indices
     );
 }
@@ -94,7 +94,7 @@ std::string SpiralVase::process_layer(const std::string &gcode, bool last_layer)
                 // If this is the initial Z move of the layer, replace it with a
                 // (redundant) move to the last Z of previous layer.
                 line.set(reader, Z, z);
-                new_gcode += line.raw() + '\n';
+                new_gcode.append(line.raw()) += '\n';
                 return;
             } else if (line.has_x() || line.has_y()) { // Sometimes lines have X/Y but the move is to the last position.
                 if (const float dist_XY = line.dist_XY(reader); dist_XY > 0 && line.extruding(reader)) { // Exclude wipe and retract
@@ -109,7 +109,7 @@ std::string SpiralVase::process_layer(const std::string &gcode, bool last_layer)
                         // We add this new layer at the very end
                         GCodeReader::GCodeLine transition_line(line);
                         transition_line.set(reader, E, line.e() * (1.f - factor), 5);
-                        transition_gcode += transition_line.raw() + '\n';
+                        transition_gcode.append(transition_line.raw()) += '\n';
                     }
 
                     // This line is the core of Spiral Vase mode, ramp up the Z smoothly
@@ -142,7 +142,7 @@ std::string SpiralVase::process_layer(const std::string &gcode, bool last_layer)
                     }
 
                     if (emit_gcode_line)
-                        new_gcode += line.raw() + '\n';
+                        new_gcode.append(line.raw()) += '\n';
                 }
                 return;
                 /*  Skip travel moves: the move to first perimeter point will
@@ -155,9 +155,9 @@ std::string SpiralVase::process_layer(const std::string &gcode, bool last_layer)
             }
         }
 
-        new_gcode += line.raw() + '\n';
+        new_gcode.append(line.raw()) += '\n';
         if (transition_out)
-            transition_gcode += line.raw() + '\n';
+            transition_gcode.append(line.raw()) += '\n';
     });
 
     m_previous_layer = std::move(current_layer);
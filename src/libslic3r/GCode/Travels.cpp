@@ -93,16 +93,23 @@ std::pair<AABBTreeLines::LinesDistancer<ObjectOrExtrusionLinef>, size_t> get_cur
     return {AABBTreeLines::LinesDistancer{std::move(lines)}, extrusion_entity_cnt};
 }
 
-void TravelObstacleTracker::init_layer(const Layer &layer, const ObjectsLayerToPrint &objects_to_print)
+TravelObstacleTracker::LayerObstacles TravelObstacleTracker::prepare_layer(const Layer &layer, const ObjectsLayerToPrint &objects_to_print)
 {
-    size_t extrusion_entity_cnt = 0;
-    m_extruded_extrusion.clear();
+    LayerObstacles out;
+    out.objects_to_print         = objects_to_print;
+    out.previous_layer_distancer = get_previous_layer_distancer(out.objects_to_print, layer.lower_layer->lslices);
+    std::tie(out.current_layer_distancer, out.extrusion_entity_cnt) = get_current_layer_distancer(out.objects_to_print);
+    return out;
+}
 
-    m_objects_to_print         = objects_to_print;
-    m_previous_layer_distancer = get_previous_layer_distancer(m_objects_to_print, layer.lower_layer->lslices);
+void TravelObstacleTracker::init_layer(LayerObstacles &&obstacles)
+{
+    m_extruded_extrusion.clear();
 
-    std::tie(m_current_layer_distancer, extrusion_entity_cnt) = get_current_layer_distancer(m_objects_to_print);
-    m_extruded_extrusion.reserve(extrusion_entity_cnt);
+    m_objects_to_print         = std::move(obstacles.objects_to_print);
+    m_previous_layer_distancer = std::move(obstacles.previous_layer_distancer);
+    m_current_layer_distancer  = std::move(obstacles.current_layer_distancer);
+    m_extruded_extrusion.reserve(obstacles.extrusion_entity_cnt);
 }
 
 void TravelObstacleTracker::mark_extruded(const ExtrusionEntity *extrusion_entity, size_t object_layer_idx, size_t instance_idx)
@@ -81,7 +81,21 @@ struct ExtrudedExtrusionEntityHash
 class TravelObstacleTracker
 {
 public:
-    void init_layer(const Layer &layer, const ObjectsLayerToPrint &objects_to_print);
+    // Obstacles of a single layer. They depend just on the geometry of the layer being printed
+    // and of the layer below, thus they may be prepared ahead of the G-code generator.
+    struct LayerObstacles
+    {
+        ObjectsLayerToPrint                                   objects_to_print;
+        AABBTreeLines::LinesDistancer<ObjectOrExtrusionLinef> previous_layer_distancer;
+        AABBTreeLines::LinesDistancer<ObjectOrExtrusionLinef> current_layer_distancer;
+        size_t                                                extrusion_entity_cnt{0};
+    };
+
+    // Thread safe, may be called from a worker thread.
+    static LayerObstacles prepare_layer(const Layer &layer, const ObjectsLayerToPrint &objects_to_print);
+
+    void init_layer(const Layer &layer, const ObjectsLayerToPrint &objects_to_print) { this->init_layer(prepare_layer(layer, objects_to_print)); }
+    void init_layer(LayerObstacles &&obstacles);
 
     void mark_extruded(const ExtrusionEntity *extrusion_entity, size_t object_layer_idx, size_t instance_idx);
 
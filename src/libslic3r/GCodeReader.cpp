@@ -4,7 +4,9 @@
 ///|/
 #include "GCodeReader.hpp"
 
-#include <boost/nowide/cstdio.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
 #include <fast_float.h>
 #include <iostream>
 #include <iomanip>
@@ -12,6 +14,11 @@
 #include <cstdio>
 #include <cstdlib>
 
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/task_arena.h>
+#include <oneapi/tbb/task_group.h>
+
 #include "Utils.hpp"
 #include "libslic3r/PrintConfig.hpp"
 #include "libslic3r/libslic3r.h"
@@ -39,6 +46,19 @@ void GCodeReader::apply_config(const DynamicPrintConfig &config)
 }
 
 const char* GCodeReader::parse_line_internal(const char *ptr, const char *end, GCodeLine &gline, std::pair<const char*, const char*> &command)
+{
+    const char *c = this->tokenize_line(ptr, end, gline, command);
+
+    if (gline.has(E) && m_config.use_relative_e_distances)
+        m_position[E] = 0;
+
+    if (m_verbose)
+        std::cout << gline.m_raw << std::endl;
+
+    return c;
+}
+
+const char* GCodeReader::tokenize_line(const char *ptr, const char *end, GCodeLine &gline, std::pair<const char*, const char*> &command) const
 {
     assert(is_decimal_separator_point());
     
@@ -90,16 +110,12 @@ const char* GCodeReader::parse_line_internal(const char *ptr, const char *end, G
                 c = skip_word(c);
         }
     }
-    
-    if (gline.has(E) && m_config.use_relative_e_distances)
-        m_position[E] = 0;
 
     // Skip the rest of the line.
     for (; ! is_end_of_line(*c); ++ c);
 
-    // Copy the raw string including the comment, without the trailing newlines.
-    if (c > ptr)
-        gline.m_raw.assign(ptr, c);
+    // Reference the raw string including the comment, without the trailing newlines.
+    gline.m_raw = std::string_view(ptr, c - ptr);
 
     // Skip the trailing newlines.
 	if (*c == '\r')
@@ -107,9 +123,6 @@ const char* GCodeReader::parse_line_internal(const char *ptr, const char *end, G
 	if (*c == '\n')
 		++ c;
 
-    if (m_verbose)
-        std::cout << gline.m_raw << std::endl;
-
     return c;
 }
 
@@ -126,65 +139,64 @@ void GCodeReader::update_coordinates(GCodeLine &gline, std::pair<const char*, co
     }
 }
 
-template<typename ParseLineCallback, typename LineEndCallback>
-bool GCodeReader::parse_file_raw_internal(const std::string &filename, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback)
+// Memory map a G-code file for reading. Empty files are not mapped.
+static bool map_gcode_file(const std::string &filename, boost::iostreams::mapped_file_source &file)
 {
-    FilePtr in{ boost::nowide::fopen(filename.c_str(), "rb") };
+    try {
+        const boost::filesystem::path path(filename);
+        if (boost::filesystem::file_size(path) > 0)
+            file.open(path);
+        return true;
+    } catch (const std::exception &) {
+        return false;
+    }
+}
 
-    fseek(in.f, 0, SEEK_END);
-    const long file_size = ftell(in.f);
-    rewind(in.f);
+// Find end of a line starting at ptr, which is terminated by '\r' or '\n' or by the end of the buffer.
+static inline const char* find_end_of_line(const char *ptr, const char *end)
+{
+    // A single forward pass, searching for '\n' first would scan up to the end of a file terminated by '\r' only for each of its lines.
+    for (; ptr != end && *ptr != '\n' && *ptr != '\r'; ++ ptr) ;
+    return ptr;
+}
 
-    // Read the input stream 64kB at a time, extract lines and process them.
-    std::vector<char> buffer(65536 * 10, 0);
-    // Line buffer.
-    std::string gcode_line;
-    size_t file_pos = 0;
+template<typename ParseLineCallback, typename LineEndCallback>
+bool GCodeReader::parse_file_raw_internal(const std::string &filename, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback)
+{
+    boost::iostreams::mapped_file_source file;
+    if (! map_gcode_file(filename, file))
+        return false;
+
+    const char *begin = file.data();
+    const char *end   = begin + file.size();
+    // Report progress every 640kB.
+    static constexpr const size_t progress_step = 65536 * 10;
+    size_t next_progress = progress_step;
+    // The last line not terminated by a newline is copied, so that all the lines passed to the callback are terminated.
+    std::string last_line;
     m_parsing = true;
-    for (;;) {
-        size_t cnt_read = ::fread(buffer.data(), 1, buffer.size(), in.f);
-        if (::ferror(in.f))
-            return false;
-
-        bool eof       = cnt_read == 0;
-        auto it        = buffer.begin();
-        auto it_bufend = buffer.begin() + cnt_read;
-        while (it != it_bufend || (eof && ! gcode_line.empty())) {
-            // Find end of line.
-            bool eol    = false;
-            auto it_end = it;
-            for (; it_end != it_bufend && ! (eol = *it_end == '\r' || *it_end == '\n'); ++ it_end)
-                if (*it_end == '\n')
-                    line_end_callback(file_pos + (it_end - buffer.begin()) + 1);
-            // End of line is indicated also if end of file was reached.
-            eol |= eof && it_end == it_bufend;
-            if (eol) {
-                if (gcode_line.empty())
-                    parse_line_callback(&(*it), &(*it_end));
-                else {
-                    gcode_line.insert(gcode_line.end(), it, it_end);
-                    parse_line_callback(gcode_line.c_str(), gcode_line.c_str() + gcode_line.size());
-                    gcode_line.clear();
-                }
-                if (! m_parsing)
-                    // The callback wishes to exit.
-                    return true;
-            } else
-                gcode_line.insert(gcode_line.end(), it, it_end);
-            // Skip EOL.
-            it = it_end; 
-            if (it != it_bufend && *it == '\r')
-                ++ it;
-            if (it != it_bufend && *it == '\n') {
-                line_end_callback(file_pos + (it - buffer.begin()) + 1);
-                ++ it;
-            }
+    for (const char *it = begin; it != end;) {
+        const char *it_end = find_end_of_line(it, end);
+        if (it_end == end) {
+            last_line.assign(it, it_end);
+            parse_line_callback(last_line.c_str(), last_line.c_str() + last_line.size());
+        } else
+            parse_line_callback(it, it_end);
+        if (! m_parsing)
+            // The callback wishes to exit.
+            return true;
+        // Skip EOL.
+        it = it_end;
+        if (it != end && *it == '\r')
+            ++ it;
+        if (it != end && *it == '\n') {
+            ++ it;
+            line_end_callback(size_t(it - begin));
+        }
+        if (m_progress_callback != nullptr && size_t(it - begin) >= next_progress) {
+            next_progress += progress_step;
+            m_progress_callback(static_cast<float>(it - begin) / static_cast<float>(end - begin));
         }
-        if (eof)
-            break;
-        file_pos += cnt_read;
-        if (m_progress_callback != nullptr)
-            m_progress_callback(static_cast<float>(file_pos) / static_cast<float>(file_size));
     }
     return true;
 }
@@ -213,6 +225,127 @@ bool GCodeReader::parse_file(const std::string& file, callback_t callback, std::
     return this->parse_file_internal(file, callback, [&lines_ends](size_t file_pos) { lines_ends.front().emplace_back(file_pos); });
 }
 
+bool GCodeReader::parse_file_parallel(const std::string &filename, callback_t callback, std::vector<std::vector<size_t>> &lines_ends)
+{
+    lines_ends.clear();
+    std::vector<size_t> &file_lines_ends = lines_ends.emplace_back();
+
+    boost::iostreams::mapped_file_source file;
+    if (! map_gcode_file(filename, file))
+        return false;
+    const char *file_begin = file.data();
+    const char *file_end   = file_begin + file.size();
+
+    // Chunk of the file ending with a complete line, its lines are parsed by a worker thread.
+    struct Chunk {
+        const char            *begin;
+        const char            *end;
+        size_t                 file_pos;
+        std::vector<GCodeLine> lines;
+        std::vector<size_t>    lines_ends;
+    };
+    static constexpr const size_t chunk_size = 256 * 1024;
+    const size_t                  chunks_per_batch = std::max<size_t>(2, 2 * size_t(tbb::this_task_arena::max_concurrency()));
+
+    // The last line not terminated by a newline is copied, so that all the lines referenced by GCodeLine are terminated.
+    std::string last_line;
+    if (file_begin != file_end && file_end[-1] != '\n' && file_end[-1] != '\r') {
+        const char *last_line_begin = file_end;
+        for (; last_line_begin != file_begin && last_line_begin[-1] != '\n' && last_line_begin[-1] != '\r'; -- last_line_begin) ;
+        last_line.assign(last_line_begin, file_end);
+        file_end = last_line_begin;
+    }
+
+    // Split the file into chunks at the end of a line.
+    const char *chunk_begin      = file_begin;
+    bool        last_line_queued = last_line.empty();
+    auto next_batch_chunks = [&](std::vector<Chunk> &batch) {
+        batch.clear();
+        while (batch.size() < chunks_per_batch && chunk_begin != file_end) {
+            const char *chunk_end = file_end;
+            if (size_t(file_end - chunk_begin) > chunk_size) {
+                chunk_end = static_cast<const char*>(memchr(chunk_begin + chunk_size, '\n', file_end - chunk_begin - chunk_size));
+                chunk_end = chunk_end == nullptr ? file_end : chunk_end + 1;
+            }
+            batch.push_back({ chunk_begin, chunk_end, size_t(chunk_begin - file_begin) });
+            chunk_begin = chunk_end;
+        }
+        if (batch.size() < chunks_per_batch && ! last_line_queued && chunk_begin == file_end) {
+            batch.push_back({ last_line.c_str(), last_line.c_str() + last_line.size(), size_t(file_end - file_begin) });
+            last_line_queued = true;
+        }
+    };
+
+    // Split lines the same way parse_file_raw_internal() does.
+    auto parse_chunk = [this](Chunk &chunk) {
+        const char *it = chunk.begin;
+        std::pair<const char*, const char*> command;
+        while (it != chunk.end) {
+            const char *it_end = find_end_of_line(it, chunk.end);
+            this->tokenize_line(it, it_end, chunk.lines.emplace_back(), command);
+            it = it_end;
+            if (it != chunk.end && *it == '\r')
+                ++ it;
+            if (it != chunk.end && *it == '\n') {
+                ++ it;
+                chunk.lines_ends.emplace_back(chunk.file_pos + (it - chunk.begin));
+            }
+        }
+    };
+    auto parse_batch = [&parse_chunk](std::vector<Chunk> &batch) {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, batch.size(), 1), [&batch, &parse_chunk](const tbb::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i < range.end(); ++ i)
+                parse_chunk(batch[i]);
+        });
+    };
+
+    const float        file_size = float(std::max<size_t>(1, file.size()));
+    std::vector<Chunk> batch;
+    std::vector<Chunk> next_batch;
+    next_batch_chunks(batch);
+    parse_batch(batch);
+    m_parsing = true;
+    while (! batch.empty()) {
+        next_batch_chunks(next_batch);
+        // Parse the next batch while the current one is being consumed by the callback.
+        tbb::task_group parse_next;
+        parse_next.run([&next_batch, &parse_batch]() { parse_batch(next_batch); });
+        try {
+            for (Chunk &chunk : batch) {
+                for (GCodeLine &gline : chunk.lines) {
+                    // Same as parse_line_internal(), the lines were just tokenized by the worker threads.
+                    if (gline.has(E) && m_config.use_relative_e_distances)
+                        m_position[E] = 0;
+                    if (m_verbose)
+                        std::cout << gline.raw() << std::endl;
+                    callback(*this, gline);
+                    std::pair<const char*, const char*> command;
+                    command.first  = skip_whitespaces(gline.raw().data());
+                    command.second = skip_word(command.first);
+                    update_coordinates(gline, command);
+                    if (! m_parsing)
+                        break;
+                }
+                append(file_lines_ends, std::move(chunk.lines_ends));
+                if (! m_parsing)
+                    break;
+                if (m_progress_callback != nullptr)
+                    m_progress_callback(static_cast<float>(chunk.file_pos + (chunk.end - chunk.begin)) / file_size);
+            }
+        } catch (...) {
+            parse_next.cancel();
+            parse_next.wait();
+            throw;
+        }
+        parse_next.wait();
+        if (! m_parsing)
+            // The callback wishes to exit.
+            return true;
+        std::swap(batch, next_batch);
+    }
+    return true;
+}
+
 bool GCodeReader::parse_file_raw(const std::string &filename, raw_line_callback_t line_callback)
 {
     return this->parse_file_raw_internal(filename,
@@ -244,13 +377,13 @@ const char* GCodeReader::axis_pos(const char *raw_str, char axis)
 
 bool GCodeReader::GCodeLine::has(char axis) const
 {
-    return GCodeReader::axis_pos(this->raw().c_str(), axis);
+    return GCodeReader::axis_pos(this->raw().data(), axis);
 }
 
 std::string_view GCodeReader::GCodeLine::axis_pos(char axis) const
 { 
-    const std::string &s = this->raw();
-    const char *c = GCodeReader::axis_pos(this->raw().c_str(), axis);
+    const std::string_view s = this->raw();
+    const char *c = GCodeReader::axis_pos(s.data(), axis);
     return c ? std::string_view{ c, s.size() - (c - s.data()) } : std::string_view();
 }
 
@@ -313,17 +446,22 @@ void GCodeReader::GCodeLine::set(const GCodeReader &reader, const Axis axis, con
         match[1] = reader.extrusion_axis();
     }
 
+    if (! this->owns_raw())
+        // Copy the raw text to be modified.
+        m_raw_storage.assign(m_raw.data(), m_raw.size());
+    std::string &raw = m_raw_storage;
     if (this->has(axis)) {
-        size_t pos = m_raw.find(match)+2;
-        size_t end = m_raw.find(' ', pos+1);
-        m_raw = m_raw.replace(pos, end-pos, ss.str());
+        size_t pos = raw.find(match)+2;
+        size_t end = raw.find(' ', pos+1);
+        raw = raw.replace(pos, end-pos, ss.str());
     } else {
-        size_t pos = m_raw.find(' ');
+        size_t pos = raw.find(' ');
         if (pos == std::string::npos)
-            m_raw += std::string(match) + ss.str();
+            raw += std::string(match) + ss.str();
         else
-            m_raw = m_raw.replace(pos, 0, std::string(match) + ss.str());
+            raw = raw.replace(pos, 0, std::string(match) + ss.str());
     }
+    m_raw = m_raw_storage;
     m_axis[axis] = new_value;
     m_mask |= 1 << int(axis);
 }
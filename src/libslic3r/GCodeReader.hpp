@@ -27,18 +27,40 @@ class GCodeReader {
 public:
     typedef std::function<void(float)> ProgressCallback;
 
+    // Parsed G-code line. The raw text is not copied, it references the parsed buffer or the memory mapped file,
+    // thus a line received by a parsing callback is only valid during the callback. The raw text is always followed
+    // by an end of line character or by zero, the parsing functions rely on it. The raw text is copied into a line
+    // owned storage only when modified by set().
     class GCodeLine {
     public:
         GCodeLine() { reset(); }
-        void reset() { m_mask = 0; memset(m_axis, 0, sizeof(m_axis)); m_raw.clear(); }
+        GCodeLine(const GCodeLine &rhs) { *this = rhs; }
+        GCodeLine(GCodeLine &&rhs) { *this = std::move(rhs); }
+        GCodeLine& operator=(const GCodeLine &rhs) {
+            m_raw_storage = rhs.m_raw_storage;
+            m_raw         = rhs.owns_raw() ? std::string_view(m_raw_storage) : rhs.m_raw;
+            memcpy(m_axis, rhs.m_axis, sizeof(m_axis));
+            m_mask        = rhs.m_mask;
+            return *this;
+        }
+        GCodeLine& operator=(GCodeLine &&rhs) {
+            const bool owns_raw = rhs.owns_raw();
+            m_raw_storage = std::move(rhs.m_raw_storage);
+            m_raw         = owns_raw ? std::string_view(m_raw_storage) : rhs.m_raw;
+            memcpy(m_axis, rhs.m_axis, sizeof(m_axis));
+            m_mask        = rhs.m_mask;
+            rhs.reset();
+            return *this;
+        }
+        void reset() { m_mask = 0; memset(m_axis, 0, sizeof(m_axis)); m_raw = std::string_view(""); m_raw_storage.clear(); }
 
-        const std::string&      raw() const { return m_raw; }
+        std::string_view        raw() const { return m_raw; }
         const std::string_view  cmd() const { 
-            const char *cmd = GCodeReader::skip_whitespaces(m_raw.c_str());
+            const char *cmd = GCodeReader::skip_whitespaces(m_raw.data());
             return std::string_view(cmd, GCodeReader::skip_word(cmd) - cmd);
         }
         const std::string_view  comment() const
-            { size_t pos = m_raw.find(';'); return (pos == std::string::npos) ? std::string_view() : std::string_view(m_raw).substr(pos + 1); }
+            { size_t pos = m_raw.find(';'); return (pos == std::string_view::npos) ? std::string_view() : m_raw.substr(pos + 1); }
 
         // Return position in this->raw() string starting with the "axis" character.
         std::string_view axis_pos(char axis) const;
@@ -66,7 +88,7 @@ public:
             float y = this->has(Y) ? (this->y() - reader.y()) : 0;
             return sqrt(x*x + y*y);
         }
-        bool cmd_is(const char *cmd_test)          const { return cmd_is(m_raw, cmd_test); }
+        bool cmd_is(const char *cmd_test)          const { return cmd_is_raw(m_raw.data(), cmd_test); }
         bool extruding(const GCodeReader &reader)  const { return this->cmd_is("G1") && this->dist_E(reader) > 0; }
         bool retracting(const GCodeReader &reader) const { return this->cmd_is("G1") && this->dist_E(reader) < 0; }
         bool travel()     const { return this->cmd_is("G1") && ! this->has(E); }
@@ -84,11 +106,7 @@ public:
         float e() const { return m_axis[E]; }
         float f() const { return m_axis[F]; }
 
-        static bool cmd_is(const std::string &gcode_line, const char *cmd_test) {
-            const char *cmd = GCodeReader::skip_whitespaces(gcode_line.c_str());
-            size_t len = strlen(cmd_test); 
-            return strncmp(cmd, cmd_test, len) == 0 && GCodeReader::is_end_of_word(cmd[len]);
-        }
+        static bool cmd_is(const std::string &gcode_line, const char *cmd_test) { return cmd_is_raw(gcode_line.c_str(), cmd_test); }
 
         static bool cmd_starts_with(const std::string& gcode_line, const char* cmd_test) {
             return strncmp(GCodeReader::skip_whitespaces(gcode_line.c_str()), cmd_test, strlen(cmd_test)) == 0;
@@ -102,7 +120,16 @@ public:
         }
 
     private:
-        std::string      m_raw;
+        static bool cmd_is_raw(const char *raw, const char *cmd_test) {
+            const char *cmd = GCodeReader::skip_whitespaces(raw);
+            size_t len = strlen(cmd_test); 
+            return strncmp(cmd, cmd_test, len) == 0 && GCodeReader::is_end_of_word(cmd[len]);
+        }
+        bool owns_raw() const { return m_raw.data() == m_raw_storage.data(); }
+
+        std::string_view m_raw;
+        // Storage of the raw text modified by set().
+        std::string      m_raw_storage;
         float            m_axis[NUM_AXES];
         uint32_t         m_mask;
         friend class GCodeReader;
@@ -146,6 +173,7 @@ public:
     void parse_line(const std::string &line, Callback callback)
         { GCodeLine gline; this->parse_line(line.c_str(), line.c_str() + line.size(), gline, callback); }
 
+    // The file is memory mapped and parsed in place, the lines passed to the callback reference the mapped memory.
     // Returns false if reading the file failed.
     bool parse_file(const std::string &file, callback_t callback);
     // Collect positions of line ends in the binary G-code to be used by the G-code viewer when memory mapping and displaying section of G-code
@@ -153,6 +181,9 @@ public:
     bool parse_file(const std::string& file, callback_t callback, std::vector<std::vector<size_t>>& lines_ends);
     // Just read the G-code file line by line, calls callback (const char *begin, const char *end). Returns false if reading the file failed.
     bool parse_file_raw(const std::string &file, raw_line_callback_t callback);
+    // Same as parse_file() collecting lines_ends, however the file is read in chunks, which are split into lines and parsed
+    // by worker threads. The callback is called in the order of the lines on the calling thread.
+    bool parse_file_parallel(const std::string &file, callback_t callback, std::vector<std::vector<size_t>> &lines_ends);
 
     // To be called by the callback to stop parsing.
     void quit_parsing() { m_parsing = false; }
@@ -183,6 +214,8 @@ private:
     bool        parse_file_internal(const std::string &filename, ParseLineCallback parse_line_callback, LineEndCallback line_end_callback);
 
     const char* parse_line_internal(const char *ptr, const char *end, GCodeLine &gline, std::pair<const char*, const char*> &command);
+    // Parse a line without modifying the state of the reader, thread safe.
+    const char* tokenize_line(const char *ptr, const char *end, GCodeLine &gline, std::pair<const char*, const char*> &command) const;
     void        update_coordinates(GCodeLine &gline, std::pair<const char*, const char*> &command);
 
     static bool         is_whitespace(char c)           { return c == ' ' || c == '\t'; }
@@ -27,7 +27,7 @@ class JPSPathFinder
     BoundingBox max_search_box;
     Lines bed_shape;
 
-    const coord_t resolution = scaled(1.5);
+    static constexpr const coord_t resolution = scaled(1.5);
     Pixel         pixelize(const Point &p) { return p / resolution; }
     Point         unpixelize(const Pixel &p) { return p * resolution; }
 
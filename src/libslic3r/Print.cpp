@@ -50,6 +50,7 @@
 #include <boost/format.hpp>
 #include <boost/log/trivial.hpp>
 #include <boost/regex.hpp>
+#include <tbb/flow_graph.h>
 
 namespace Slic3r {
 
@@ -69,6 +70,7 @@ void Print::clear()
 	m_objects.clear();
     m_print_regions.clear();
     m_model.clear_objects();
+    m_slice_cache.clear();
 }
 
 // Called by Print::apply().
@@ -902,30 +904,58 @@ void Print::process()
 
     BOOST_LOG_TRIVIAL(info) << "Starting the slicing process." << log_memory_info();
 
-    tbb::parallel_for(tbb::blocked_range<size_t>(0, m_objects.size(), 1), [this](const tbb::blocked_range<size_t> &range) {
-        for (size_t idx = range.begin(); idx < range.end(); ++idx) {
-            m_objects[idx]->make_perimeters();
-            m_objects[idx]->infill();
-            m_objects[idx]->ironing();
+    // The object steps are scheduled by a dependency graph instead of running each step for all objects
+    // before proceeding to the next step. Thus the support material of a small object may be generated
+    // while a large object is still being infilled. Each step parallelizes over the layers of its object.
+    //
+    // The support spots search writes to m_shared_regions: The support spots are calculated by the first PrintObject
+    // referencing the PrintObjectRegions and reused by the others. Therefore the PrintObjects sharing
+    // PrintObjectRegions are processed serially by a single node of the graph, which waits for all the PrintObjects
+    // of its group to be infilled, while the groups of PrintObjects with distinct PrintObjectRegions are processed in parallel.
+    {
+        std::vector<std::vector<PrintObject*>>       objects_by_shared_regions;
+        std::map<const PrintObjectRegions*, size_t>  shared_regions_to_group;
+        for (PrintObject *obj : m_objects) {
+            auto [it, inserted] = shared_regions_to_group.emplace(obj->shared_regions(), objects_by_shared_regions.size());
+            if (inserted)
+                objects_by_shared_regions.emplace_back();
+            objects_by_shared_regions[it->second].emplace_back(obj);
         }
-    }, tbb::simple_partitioner());
 
-    // The following step writes to m_shared_regions, it should not run in parallel.
-    for (PrintObject *obj : m_objects)
-        obj->generate_support_spots();
+        using StepNode = tbb::flow::continue_node<tbb::flow::continue_msg>;
+        tbb::flow::graph                                    graph;
+        tbb::flow::broadcast_node<tbb::flow::continue_msg>  start(graph);
+        // Node instances are not movable, thus they are allocated on heap and referenced directly, not through the vector.
+        std::vector<std::unique_ptr<StepNode>>              nodes;
+        for (const std::vector<PrintObject*> &group : objects_by_shared_regions) {
+            StepNode &support_spots = *nodes.emplace_back(std::make_unique<StepNode>(graph, [&group](const tbb::flow::continue_msg&) {
+                for (PrintObject *obj : group)
+                    obj->generate_support_spots();
+            }));
+            for (PrintObject *obj : group) {
+                StepNode &infill = *nodes.emplace_back(std::make_unique<StepNode>(graph, [obj](const tbb::flow::continue_msg&) {
+                    obj->make_perimeters();
+                    obj->infill();
+                    obj->ironing();
+                }));
+                StepNode &support = *nodes.emplace_back(std::make_unique<StepNode>(graph, [obj](const tbb::flow::continue_msg&) {
+                    obj->generate_support_material();
+                    obj->estimate_curled_extrusions();
+                    obj->calculate_overhanging_perimeters();
+                }));
+                tbb::flow::make_edge(start, infill);
+                tbb::flow::make_edge(infill, support_spots);
+                tbb::flow::make_edge(support_spots, support);
+            }
+        }
+        start.try_put(tbb::flow::continue_msg());
+        // Rethrows an exception thrown by any of the nodes, for example the CanceledException.
+        graph.wait_for_all();
+    }
     // check data from previous step, format the error message(s) and send alert to ui
     // this also has to be done sequentially.
     alert_when_supports_needed();
 
-    tbb::parallel_for(tbb::blocked_range<size_t>(0, m_objects.size(), 1), [this](const tbb::blocked_range<size_t> &range) {
-        for (size_t idx = range.begin(); idx < range.end(); ++idx) {
-            PrintObject &obj = *m_objects[idx];
-            obj.generate_support_material();
-            obj.estimate_curled_extrusions();
-            obj.calculate_overhanging_perimeters();
-        }
-    }, tbb::simple_partitioner());
-
     if (this->set_started(psWipeTower)) {
         m_wipe_tower_data.clear();
         m_tool_ordering.clear();
@@ -959,7 +989,10 @@ void Print::process()
         if (this->has_brim()) {
             Polygons islands_area;
             m_brim = make_brim(*this, this->make_try_cancel(), islands_area);
-            for (Polygon &poly : union_(this->first_layer_islands(), islands_area))
+            Polygons islands = this->first_layer_islands();
+            append(islands, std::move(islands_area));
+            // Only the convex hull of the union is used, thus the order of the united polygons does not matter.
+            for (Polygon &poly : union_parallel(islands))
                 append(m_first_layer_convex_hull.points, std::move(poly.points));
         }
 
@@ -29,6 +29,7 @@
 #include "ExtrusionEntityCollection.hpp"
 #include "Flow.hpp"
 #include "Point.hpp"
+#include "SliceCache.hpp"
 #include "Slicing.hpp"
 #include "SupportSpotsGenerator.hpp"
 #include "TriangleMeshSlicer.hpp"
@@ -270,6 +271,17 @@ private:
     size_t                                      m_ref_cnt{ 0 };
 };
 
+// ModelVolume sliced by PrintObject with its transformation. If the volume is sliced again with the same transformation,
+// for example after the layer heights changed, the slicing index of its mesh is built and retained for the next slicing,
+// so that the following re-slicing does not make another pass over the whole mesh.
+struct VolumeSlicingIndex
+{
+    ObjectID                                volume_id;
+    Transform3d                             trafo;
+    // Null if the volume was sliced just once with this transformation.
+    std::shared_ptr<const MeshSlicingIndex> index;
+};
+
 class PrintObject : public PrintObjectBaseWithState<Print, PrintObjectStep, posCount>
 {
 private: // Prevents erroneous use by other classes.
@@ -426,7 +438,9 @@ private:
     void combine_infill();
     void _generate_support_material();
     std::pair<FillAdaptive::OctreePtr, FillAdaptive::OctreePtr> prepare_adaptive_infill_data(
-        const std::vector<std::pair<const Surface*, float>>& surfaces_w_bottom_z) const;
+        const std::vector<std::pair<const Surface*, float>>& surfaces_w_bottom_z,
+        // Octrees of the previous run, reused if still valid.
+        std::pair<FillAdaptive::OctreePtr, FillAdaptive::OctreePtr> &&previous) const;
     FillLightning::GeneratorPtr prepare_lightning_infill_data();
 
     // XYZ in scaled coordinates
@@ -452,6 +466,9 @@ private:
     // so that next call to make_perimeters() performs a union() before computing loops
     bool                    				m_typed_slices = false;
 
+    // Slicing indices of the volumes sliced by the last slice_volumes().
+    std::vector<VolumeSlicingIndex>         m_volume_slicing_indices;
+
     std::pair<FillAdaptive::OctreePtr, FillAdaptive::OctreePtr> m_adaptive_fill_octrees;
     FillLightning::GeneratorPtr m_lightning_generator;
 };
@@ -617,6 +634,16 @@ public:
     // Exports G-code into a file name based on the path_template, returns the file path of the generated G-code file.
     // If preview_data is not null, the preview_data is filled in for the G-code visualization (not used by the command line Slic3r).
     std::string         export_gcode(const std::string& path_template, GCodeProcessorResult* result, ThumbnailsGeneratorCallback thumbnail_cb = nullptr);
+    // If enabled and export_gcode() is called without GCodeProcessorResult, the moves are discarded by the G-code processor
+    // as soon as their print times are known, so that the memory used by exporting a huge print is bounded.
+    void                enable_gcode_streaming(bool enabled) { m_gcode_streaming = enabled; }
+    bool                gcode_streaming_enabled() const { return m_gcode_streaming; }
+    // If enabled, export_gcode() reserves lines of fixed width for the print time estimates and fills them in place,
+    // thus the G-code file is written just once instead of being written, read back and written again.
+    // The M73 lines are emitted every minute of print time rather than at each change of the percentage or the remaining minutes,
+    // and the reserved lines are padded with trailing spaces, see GCodeProcessor::enable_single_pass().
+    void                enable_gcode_single_pass(bool enabled) { m_gcode_single_pass = enabled; }
+    bool                gcode_single_pass_enabled() const { return m_gcode_single_pass; }
 
     // methods for handling state
     bool                is_step_done(PrintStep step) const { return Inherited::is_step_done(step); }
@@ -676,6 +703,8 @@ public:
 
     const PrintStatistics&      print_statistics() const { return m_print_statistics; }
     PrintStatistics&            print_statistics() { return m_print_statistics; }
+    // Slices of the model volumes shared by the PrintObjects and retained between the slicing runs.
+    const SliceCache&           slice_cache() const { return m_slice_cache; }
 
     // Wipe tower support.
     bool                        has_wipe_tower() const;
@@ -741,6 +770,9 @@ private:
     // Estimated print time, filament consumed.
     PrintStatistics                         m_print_statistics;
 
+    // Slices of the model volumes retained between the slicing runs and shared by PrintObjects with identical volumes.
+    SliceCache                              m_slice_cache;
+
     // To allow GCode to set the Print's GCodeExport step status.
     friend class GCodeGenerator;
     // To allow GCodeProcessor to emit warnings.
@@ -750,6 +782,9 @@ private:
 
     ConflictResultOpt m_conflict_result;
     std::optional<std::pair<std::string, std::string>> m_sequential_collision_detected; // names of objects (hit first when printing second)
+
+    bool                                    m_gcode_streaming { false };
+    bool                                    m_gcode_single_pass { false };
 };
 
 } /* slic3r_Print_hpp_ */
@@ -5993,6 +5993,18 @@ CLIMiscConfigDef::CLIMiscConfigDef()
         "For example. loglevel=2 logs fatal, error and warning level messages.");
     def->min = 0;
 
+    def = this->add("gcode_streaming", coBool);
+    def->label = L("Stream G-code processing");
+    def->tooltip = L("Do not keep the G-code moves in memory while estimating the print time of the exported G-code. "
+        "This limits the memory used when exporting huge prints.");
+
+    def = this->add("gcode_single_pass", coBool);
+    def->label = L("Write G-code in a single pass");
+    def->tooltip = L("Reserve space for the print time estimates in the output file and fill it in place, so that the output file "
+        "is written just once. This speeds up exporting to slow or network drives. Not applicable to binary G-code. "
+        "The remaining time (M73) is reported every minute of print time instead of at each change of the percentage, "
+        "and the lines filled in place are padded with spaces.");
+
 #ifdef SLIC3R_GUI
     def = this->add("opengl-aa", coBool);
     def->label = L("Automatic OpenGL antialiasing samples number selection");
@@ -617,7 +617,8 @@ void PrintObject::calculate_overhanging_perimeters()
 }
 
 std::pair<FillAdaptive::OctreePtr, FillAdaptive::OctreePtr> PrintObject::prepare_adaptive_infill_data(
-    const std::vector<std::pair<const Surface *, float>> &surfaces_w_bottom_z) const
+    const std::vector<std::pair<const Surface *, float>> &surfaces_w_bottom_z,
+    std::pair<FillAdaptive::OctreePtr, FillAdaptive::OctreePtr> &&previous) const
 {
     using namespace FillAdaptive;
 
@@ -649,9 +650,10 @@ std::pair<FillAdaptive::OctreePtr, FillAdaptive::OctreePtr> PrintObject::prepare
     for (size_t i = 1; i < overhangs.size(); ++ i)
         append(overhangs.front(), std::move(overhangs[i]));
 
+    // The octrees are reused if the settings changed do not affect them.
     return std::make_pair(
-        adaptive_line_spacing ? build_octree(mesh, overhangs.front(), adaptive_line_spacing, false) : OctreePtr(),
-        support_line_spacing  ? build_octree(mesh, overhangs.front(), support_line_spacing, true) : OctreePtr());
+        adaptive_line_spacing ? build_octree(mesh, overhangs.front(), adaptive_line_spacing, false, std::move(previous.first)) : OctreePtr(),
+        support_line_spacing  ? build_octree(mesh, overhangs.front(), support_line_spacing, true, std::move(previous.second)) : OctreePtr());
 }
 
 FillLightning::GeneratorPtr PrintObject::prepare_lightning_infill_data()
@@ -997,6 +999,8 @@ bool PrintObject::invalidate_all_steps()
     bool result = Inherited::invalidate_all_steps() | m_print->invalidate_all_steps();
 	// Then reset some of the depending values.
 	m_slicing_params.valid = false;
+	// The volumes or their transformations may have changed.
+	m_volume_slicing_indices.clear();
 	return result;
 }
 
@@ -1987,7 +1991,7 @@ void PrintObject::bridge_over_infill()
             }
         }
 
-        this->m_adaptive_fill_octrees = this->prepare_adaptive_infill_data(surfaces_w_bottom_z);
+        this->m_adaptive_fill_octrees = this->prepare_adaptive_infill_data(surfaces_w_bottom_z, std::move(this->m_adaptive_fill_octrees));
 
         std::vector<size_t> layers_to_generate_infill;
         for (const auto &pair : surfaces_by_layer) {
@@ -3088,7 +3092,16 @@ void PrintObject::discover_horizontal_shells()
 // fill_surfaces but we only turn them into VOID surfaces, thus preserving the boundaries.
 void PrintObject::combine_infill()
 {
-    // Work on each region separately.
+    // A group of layers of a single region, whose sparse infill is to be combined.
+    // The groups of all regions are disjoint and they are processed in parallel.
+    struct CombineGroup {
+        size_t region_id;
+        // Index of the uppermost layer of the group.
+        size_t layer_idx;
+        size_t num_layers;
+    };
+    std::vector<CombineGroup> groups;
+
     for (size_t region_id = 0; region_id < this->num_printing_regions(); ++region_id) {
         const PrintRegion &region                        = this->printing_region(region_id);
         const size_t       combine_infill_every_n_layers = region.config().infill_every_layers.value;
@@ -3135,23 +3148,29 @@ void PrintObject::combine_infill()
             // Append lower layers (if any) to uppermost layer.
             combine[m_layers.size() - 1] = num_layers;
         }
-        
-        // loop through layers to which we have assigned layers to combine
-        for (size_t layer_idx = 0; layer_idx < m_layers.size(); ++ layer_idx) {
+
+        // Collect the layers to which we have assigned layers to combine.
+        for (size_t layer_idx = 0; layer_idx < m_layers.size(); ++ layer_idx)
+            if (combine[layer_idx] > 1)
+                groups.push_back({ region_id, layer_idx, combine[layer_idx] });
+    }
+
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, groups.size(), 1),
+        [this, &groups](const tbb::blocked_range<size_t> &range) {
+        for (size_t group_idx = range.begin(); group_idx < range.end(); ++ group_idx) {
             m_print->throw_if_canceled();
-            size_t num_layers = combine[layer_idx];
-			if (num_layers <= 1)
-                continue;
+            const CombineGroup &group  = groups[group_idx];
+            const PrintRegion  &region = this->printing_region(group.region_id);
             // Get all the LayerRegion objects to be combined.
             std::vector<LayerRegion*> layerms;
-            layerms.reserve(num_layers);
-			for (size_t i = layer_idx + 1 - num_layers; i <= layer_idx; ++ i)
-                layerms.emplace_back(m_layers[i]->regions()[region_id]);
+            layerms.reserve(group.num_layers);
+            for (size_t i = group.layer_idx + 1 - group.num_layers; i <= group.layer_idx; ++ i)
+                layerms.emplace_back(m_layers[i]->regions()[group.region_id]);
             // We need to perform a multi-layer intersection, so let's split it in pairs.
             // Initialize the intersection with the candidates of the lowest layer.
             ExPolygons intersection = to_expolygons(layerms.front()->fill_surfaces().filter_by_type(stInternal));
             // Start looping from the second layer and intersect the current intersection with it.
-            for (size_t i = 1; i < layerms.size(); ++ i)
+            for (size_t i = 1; i < layerms.size() && ! intersection.empty(); ++ i)
                 intersection = intersection_ex(layerms[i]->fill_surfaces().filter_by_type(stInternal), intersection);
             double area_threshold = layerms.front()->infill_area_threshold();
             if (! intersection.empty() && area_threshold > 0.)
@@ -3160,10 +3179,6 @@ void PrintObject::combine_infill()
                     intersection.end());
             if (intersection.empty())
                 continue;
-//            Slic3r::debugf "  combining %d %s regions from layers %d-%d\n",
-//                scalar(@$intersection),
-//                ($type == stInternal ? 'internal' : 'internal-solid'),
-//                $layer_idx-($every-1), $layer_idx;
             // intersection now contains the regions that can be combined across the full amount of layers,
             // so let's remove those areas from all layers.
             Polygons intersection_with_clearance;
@@ -3181,9 +3196,14 @@ void PrintObject::combine_infill()
             for (ExPolygon &expoly : intersection)
                 polygons_append(intersection_with_clearance, offset(expoly, clearance_offset));
             for (LayerRegion *layerm : layerms) {
-                Polygons internal = to_polygons(std::move(layerm->fill_surfaces().filter_by_type(stInternal)));
+                // Clip the internal surfaces in place, without copying them to polygons first.
+                const SurfacesPtr internal      = layerm->fill_surfaces().filter_by_type(stInternal);
+                ExPolygons        internal_new  = diff_ex(internal, intersection_with_clearance);
+                ExPolygons        internal_void;
+                if (layerm != layerms.back())
+                    internal_void = intersection_ex(internal, intersection_with_clearance);
                 layerm->m_fill_surfaces.remove_type(stInternal);
-                layerm->m_fill_surfaces.append(diff_ex(internal, intersection_with_clearance), stInternal);
+                layerm->m_fill_surfaces.append(std::move(internal_new), stInternal);
                 if (layerm == layerms.back()) {
                     // Apply surfaces back with adjusted depth to the uppermost layer.
                     Surface templ(stInternal, ExPolygon());
@@ -3194,13 +3214,11 @@ void PrintObject::combine_infill()
                     layerm->m_fill_surfaces.append(intersection, templ);
                 } else {
                     // Save void surfaces.
-                    layerm->m_fill_surfaces.append(
-                        intersection_ex(internal, intersection_with_clearance),
-                        stInternalVoid);
+                    layerm->m_fill_surfaces.append(std::move(internal_void), stInternalVoid);
                 }
             }
         }
-    }
+    });
 } // void PrintObject::combine_infill()
 
 void PrintObject::_generate_support_material()
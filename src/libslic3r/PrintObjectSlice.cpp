@@ -21,6 +21,7 @@
 #include "MultiMaterialSegmentation.hpp"
 #include "Print.hpp"
 #include "ShortestPath.hpp"
+#include "SliceCache.hpp"
 #include "admesh/stl.h"
 #include "libslic3r/Feature/Interlocking/InterlockingGenerator.hpp"
 #include "libslic3r/BoundingBox.hpp"
@@ -69,26 +70,84 @@ LayerPtrs new_layers(
     return out;
 }
 
+// Find the slicing index of a volume sliced by the previous slicing with the same transformation.
+// The index is only built when a volume is sliced again with the same transformation, for example after the layer heights changed,
+// a volume sliced just once is sliced without the index. The volume is recorded into out_indices for the next slicing if out_indices is not null.
+// If build_index is false, the volume is just recorded, an index built by the previous slicing is kept, but no new index is built.
+static std::shared_ptr<const MeshSlicingIndex> volume_slicing_index(
+    const ModelVolume                           &volume,
+    const Transform3d                           &trafo,
+    const std::vector<VolumeSlicingIndex>       &cached_indices,
+    std::vector<VolumeSlicingIndex>             *out_indices,
+    bool                                         build_index,
+    const std::function<void()>                 &throw_on_cancel_callback)
+{
+    if (out_indices == nullptr)
+        return {};
+    auto same_volume = [&volume, &trafo](const VolumeSlicingIndex &vsi) { return vsi.volume_id == volume.id() && vsi.trafo.matrix() == trafo.matrix(); };
+    // Volume sliced already by this slicing, for example by multiple layer ranges.
+    if (auto it = std::find_if(out_indices->begin(), out_indices->end(), same_volume); it != out_indices->end())
+        return it->index;
+    std::shared_ptr<const MeshSlicingIndex> index;
+    if (auto it = std::find_if(cached_indices.begin(), cached_indices.end(), same_volume); it != cached_indices.end()) {
+        index = it->index;
+        if (! index && build_index) {
+            if (trafo.rotation().determinant() < 0.) {
+                indexed_triangle_set its = volume.mesh().its;
+                its_flip_triangles(its);
+                index = std::make_shared<const MeshSlicingIndex>(its, trafo, throw_on_cancel_callback);
+            } else
+                index = std::make_shared<const MeshSlicingIndex>(volume.mesh().its, trafo, throw_on_cancel_callback);
+        }
+    }
+    out_indices->push_back({ volume.id(), trafo, index });
+    return index;
+}
+
 // Slice single triangle mesh.
+// If slice_cache is not null, the slices are taken from the cache if a volume with the same mesh was sliced already
+// with the same transformation and parameters, otherwise the new slices are stored into the cache.
+static std::vector<ExPolygons> slice_volume(
+    const ModelVolume                           &volume,
+    const std::vector<float>                    &zs, 
+    const MeshSlicingParamsEx                   &params,
+    const std::vector<VolumeSlicingIndex>       &cached_indices,
+    std::vector<VolumeSlicingIndex>             *out_indices,
+    SliceCache                                  *slice_cache,
+    const std::function<void()>                 &throw_on_cancel_callback)
+{
+    std::vector<ExPolygons> layers;
+    if (! zs.empty() && ! volume.mesh().its.indices.empty()) {
+        MeshSlicingParamsEx params_volume = params;
+        params_volume.trafo = params.trafo * volume.get_matrix();
+        if (slice_cache)
+            if (std::optional<std::vector<ExPolygons>> cached = slice_cache->find(volume.mesh_ptr(), zs, params_volume); cached) {
+                // Record the volume as sliced, so that its index is built if it is sliced again without hitting the cache.
+                volume_slicing_index(volume, params_volume.trafo, cached_indices, out_indices, false, throw_on_cancel_callback);
+                return std::move(*cached);
+            }
+        if (std::shared_ptr<const MeshSlicingIndex> index = volume_slicing_index(volume, params_volume.trafo, cached_indices, out_indices, true, throw_on_cancel_callback); index)
+            layers = slice_mesh_ex(*index, zs, params_volume, throw_on_cancel_callback);
+        else if (params_volume.trafo.rotation().determinant() < 0.) {
+            indexed_triangle_set its = volume.mesh().its;
+            its_flip_triangles(its);
+            layers = slice_mesh_ex(its, zs, params_volume, throw_on_cancel_callback);
+        } else
+            layers = slice_mesh_ex(volume.mesh().its, zs, params_volume, throw_on_cancel_callback);
+        throw_on_cancel_callback();
+        if (slice_cache)
+            slice_cache->insert(volume.mesh_ptr(), zs, params_volume, layers);
+    }
+    return layers;
+}
+
 static std::vector<ExPolygons> slice_volume(
     const ModelVolume             &volume,
     const std::vector<float>      &zs, 
     const MeshSlicingParamsEx     &params,
     const std::function<void()>   &throw_on_cancel_callback)
 {
-    std::vector<ExPolygons> layers;
-    if (! zs.empty()) {
-        indexed_triangle_set its = volume.mesh().its;
-        if (its.indices.size() > 0) {
-            MeshSlicingParamsEx params2 { params };
-            params2.trafo = params2.trafo * volume.get_matrix();
-            if (params2.trafo.rotation().determinant() < 0.)
-                its_flip_triangles(its);
-            layers = slice_mesh_ex(its, zs, params2, throw_on_cancel_callback);
-            throw_on_cancel_callback();
-        }
-    }
-    return layers;
+    return slice_volume(volume, zs, params, {}, nullptr, nullptr, throw_on_cancel_callback);
 }
 
 // Slice single triangle mesh.
@@ -98,13 +157,16 @@ static std::vector<ExPolygons> slice_volume(
     const std::vector<float>                    &z,
     const std::vector<t_layer_height_range>     &ranges,
     const MeshSlicingParamsEx                   &params,
+    const std::vector<VolumeSlicingIndex>       &cached_indices,
+    std::vector<VolumeSlicingIndex>             *out_indices,
+    SliceCache                                  *slice_cache,
     const std::function<void()>                 &throw_on_cancel_callback)
 {
     std::vector<ExPolygons> out;
     if (! z.empty() && ! ranges.empty()) {
         if (ranges.size() == 1 && z.front() >= ranges.front().first && z.back() < ranges.front().second) {
             // All layers fit into a single range.
-            out = slice_volume(volume, z, params, throw_on_cancel_callback);
+            out = slice_volume(volume, z, params, cached_indices, out_indices, slice_cache, throw_on_cancel_callback);
         } else {
             std::vector<float>                     z_filtered;
             std::vector<std::pair<size_t, size_t>> n_filtered;
@@ -120,7 +182,7 @@ static std::vector<ExPolygons> slice_volume(
                     n_filtered.emplace_back(std::make_pair(first, i));
             }
             if (! n_filtered.empty()) {
-                std::vector<ExPolygons> layers = slice_volume(volume, z_filtered, params, throw_on_cancel_callback);
+                std::vector<ExPolygons> layers = slice_volume(volume, z_filtered, params, cached_indices, out_indices, slice_cache, throw_on_cancel_callback);
                 out.assign(z.size(), ExPolygons());
                 i = 0;
                 for (const std::pair<size_t, size_t> &span : n_filtered)
@@ -155,6 +217,12 @@ static std::vector<VolumeSlices> slice_volumes_inner(
     ModelVolumePtrs                                           model_volumes,
     const std::vector<PrintObjectRegions::LayerRangeRegions> &layer_ranges,
     const std::vector<float>                                 &zs,
+    // Slicing indices of the volumes from the previous slicing.
+    const std::vector<VolumeSlicingIndex>                    &cached_indices,
+    // Slicing indices of the volumes sliced now.
+    std::vector<VolumeSlicingIndex>                          &out_indices,
+    // Slices of volumes shared by all PrintObjects of a Print.
+    SliceCache                                               *slice_cache,
     const std::function<void()>                              &throw_on_cancel_callback)
 {
     model_volumes_sort_by_id(model_volumes);
@@ -204,7 +272,7 @@ static std::vector<VolumeSlices> slice_volumes_inner(
                     }
                     out.push_back({
                         model_volume->id(), 
-                        slice_volume(*model_volume, zs, params, throw_on_cancel_callback)
+                        slice_volume(*model_volume, zs, params, cached_indices, &out_indices, slice_cache, throw_on_cancel_callback)
                     });
                 }
             } else {
@@ -216,7 +284,7 @@ static std::vector<VolumeSlices> slice_volumes_inner(
                 if (! slicing_ranges.empty())
                     out.push_back({ 
                         model_volume->id(), 
-                        slice_volume(*model_volume, zs, slicing_ranges, params, throw_on_cancel_callback)
+                        slice_volume(*model_volume, zs, slicing_ranges, params, cached_indices, &out_indices, slice_cache, throw_on_cancel_callback)
                     });
             }
             if (! out.empty() && out.back().slices.empty())
@@ -867,11 +935,17 @@ void PrintObject::slice_volumes()
     }
 
     std::vector<float>                   slice_zs      = zs_from_layers(m_layers);
+    // Release the cached slices of the volumes deleted from the Model.
+    m_print->m_slice_cache.purge_released();
+    // Keep the slicing indices of just the volumes sliced now.
+    std::vector<VolumeSlicingIndex>      cached_indices;
+    cached_indices.swap(m_volume_slicing_indices);
     std::vector<std::vector<ExPolygons>> region_slices = slices_to_regions(this->model_object()->volumes, *m_shared_regions, slice_zs,
         slice_volumes_inner(
             print->config(), this->config(), this->trafo_centered(),
-            this->model_object()->volumes, m_shared_regions->layer_ranges, slice_zs, throw_on_cancel_callback),
+            this->model_object()->volumes, m_shared_regions->layer_ranges, slice_zs, cached_indices, m_volume_slicing_indices, &m_print->m_slice_cache, throw_on_cancel_callback),
         throw_on_cancel_callback);
+    cached_indices.clear();
 
     for (size_t region_id = 0; region_id < region_slices.size(); ++ region_id) {
         std::vector<ExPolygons> &by_layer = region_slices[region_id];
@@ -0,0 +1,129 @@
+#include "SliceCache.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "TriangleMesh.hpp"
+
+namespace Slic3r {
+
+static bool its_content_equal(const indexed_triangle_set &lhs, const indexed_triangle_set &rhs)
+{
+    return lhs.vertices.size() == rhs.vertices.size() && lhs.indices.size() == rhs.indices.size() &&
+           memcmp(lhs.vertices.data(), rhs.vertices.data(), lhs.vertices.size() * sizeof(stl_vertex)) == 0 &&
+           memcmp(lhs.indices.data(), rhs.indices.data(), lhs.indices.size() * sizeof(stl_triangle_vertex_indices)) == 0;
+}
+
+static bool slicing_params_equal(const MeshSlicingParamsEx &lhs, const MeshSlicingParamsEx &rhs)
+{
+    return lhs.mode == rhs.mode && lhs.slicing_mode_normal_below_layer == rhs.slicing_mode_normal_below_layer &&
+           (lhs.slicing_mode_normal_below_layer == 0 || lhs.mode_below == rhs.mode_below) &&
+           lhs.trafo.matrix() == rhs.trafo.matrix() &&
+           lhs.closing_radius == rhs.closing_radius && lhs.extra_offset == rhs.extra_offset && lhs.resolution == rhs.resolution;
+}
+
+static size_t slices_memory_usage(const std::vector<ExPolygons> &slices)
+{
+    size_t out = slices.capacity() * sizeof(ExPolygons);
+    for (const ExPolygons &expolygons : slices) {
+        out += expolygons.capacity() * sizeof(ExPolygon);
+        for (const ExPolygon &expolygon : expolygons) {
+            out += expolygon.contour.points.capacity() * sizeof(Point) + expolygon.holes.capacity() * sizeof(Polygon);
+            for (const Polygon &hole : expolygon.holes)
+                out += hole.points.capacity() * sizeof(Point);
+        }
+    }
+    return out;
+}
+
+uint64_t SliceCache::mesh_hash(const std::shared_ptr<const TriangleMesh> &mesh)
+{
+    {
+        std::scoped_lock<std::mutex> lock(m_mutex);
+        for (const auto &[cached_mesh, hash] : m_mesh_hashes)
+            if (! cached_mesh.owner_before(mesh) && ! mesh.owner_before(cached_mesh))
+                return hash;
+    }
+    // Hash the mesh without blocking the other users of the cache.
+    const uint64_t hash = its_content_hash(mesh->its);
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    m_mesh_hashes.emplace_back(mesh, hash);
+    return hash;
+}
+
+std::list<SliceCache::Entry>::iterator SliceCache::find_entry(
+    const std::shared_ptr<const TriangleMesh> &mesh, uint64_t mesh_hash, const std::vector<float> &zs, const MeshSlicingParamsEx &params)
+{
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++ it)
+        if (it->mesh_hash == mesh_hash && it->zs == zs && slicing_params_equal(it->params, params)) {
+            // Verify the mesh content against a mesh sliced into this entry, which is still alive. Hash collisions are thus harmless.
+            bool same_content = false;
+            for (const std::weak_ptr<const TriangleMesh> &weak_mesh : it->meshes)
+                if (std::shared_ptr<const TriangleMesh> other = weak_mesh.lock(); other) {
+                    if (other == mesh || its_content_equal(other->its, mesh->its)) {
+                        same_content = true;
+                        break;
+                    }
+                }
+            if (same_content)
+                return it;
+        }
+    return m_entries.end();
+}
+
+std::optional<std::vector<ExPolygons>> SliceCache::find(const std::shared_ptr<const TriangleMesh> &mesh, const std::vector<float> &zs, const MeshSlicingParamsEx &params)
+{
+    const uint64_t hash = this->mesh_hash(mesh);
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    auto it = this->find_entry(mesh, hash, zs, params);
+    if (it == m_entries.end())
+        return std::nullopt;
+    // Remember the mesh, so that the slices are retained as long as any of the meshes sliced into them is alive.
+    if (std::none_of(it->meshes.begin(), it->meshes.end(), [&mesh](const std::weak_ptr<const TriangleMesh> &m){ return m.lock() == mesh; }))
+        it->meshes.emplace_back(mesh);
+    // Move to the front of the LRU list.
+    m_entries.splice(m_entries.begin(), m_entries, it);
+    return std::make_optional(it->slices);
+}
+
+void SliceCache::insert(const std::shared_ptr<const TriangleMesh> &mesh, const std::vector<float> &zs, const MeshSlicingParamsEx &params, const std::vector<ExPolygons> &slices)
+{
+    const size_t memory_usage = slices_memory_usage(slices) + zs.capacity() * sizeof(float);
+    if (memory_usage > MemoryLimit)
+        return;
+    const uint64_t hash = this->mesh_hash(mesh);
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    if (this->find_entry(mesh, hash, zs, params) != m_entries.end())
+        // Inserted by another thread in the meantime.
+        return;
+    m_entries.push_front({ hash, { mesh }, zs, params, slices, memory_usage });
+    m_memory_usage += memory_usage;
+    while (m_memory_usage > MemoryLimit) {
+        m_memory_usage -= m_entries.back().memory_usage;
+        m_entries.pop_back();
+    }
+}
+
+void SliceCache::purge_released()
+{
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        it->meshes.erase(std::remove_if(it->meshes.begin(), it->meshes.end(), [](const std::weak_ptr<const TriangleMesh> &m){ return m.expired(); }), it->meshes.end());
+        if (it->meshes.empty()) {
+            m_memory_usage -= it->memory_usage;
+            it = m_entries.erase(it);
+        } else
+            ++ it;
+    }
+    m_mesh_hashes.erase(std::remove_if(m_mesh_hashes.begin(), m_mesh_hashes.end(), [](const auto &v){ return v.first.expired(); }), m_mesh_hashes.end());
+}
+
+void SliceCache::clear()
+{
+    std::scoped_lock<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    m_mesh_hashes.clear();
+    m_memory_usage = 0;
+}
+
+} // namespace Slic3r
@@ -0,0 +1,67 @@
+#ifndef slic3r_SliceCache_hpp_
+#define slic3r_SliceCache_hpp_
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "ExPolygon.hpp"
+#include "TriangleMeshSlicer.hpp"
+
+namespace Slic3r {
+
+class TriangleMesh;
+
+// Cache of the slices of ModelVolumes retained by Print between the slicing runs.
+// The slices are addressed by the content of the mesh, by the transformation of the mesh and by the slicing parameters,
+// thus identical volumes of different PrintObjects (for example identical parts with different print settings) are sliced
+// just once, and the slices survive invalidation of the PrintObjects, for example if just the regions of an object changed.
+// The cache is thread safe.
+class SliceCache
+{
+public:
+    // Slices of a single volume exceeding this limit are not cached, least recently used slices are dropped
+    // to keep the memory used by the cache under this limit.
+    static constexpr const size_t MemoryLimit = size_t(256) << 20;
+
+    // Returns a copy of the cached slices of a mesh transformed and sliced with the given parameters.
+    std::optional<std::vector<ExPolygons>> find(const std::shared_ptr<const TriangleMesh> &mesh, const std::vector<float> &zs, const MeshSlicingParamsEx &params);
+    void            insert(const std::shared_ptr<const TriangleMesh> &mesh, const std::vector<float> &zs, const MeshSlicingParamsEx &params, const std::vector<ExPolygons> &slices);
+    // Drop the slices of meshes no more referenced by any Model.
+    void            purge_released();
+    void            clear();
+
+    size_t          size() const { std::scoped_lock<std::mutex> lock(m_mutex); return m_entries.size(); }
+    size_t          memory_usage() const { std::scoped_lock<std::mutex> lock(m_mutex); return m_memory_usage; }
+
+private:
+    struct Entry {
+        uint64_t                                        mesh_hash;
+        // Meshes with the same content, which were sliced into these slices.
+        std::vector<std::weak_ptr<const TriangleMesh>>  meshes;
+        std::vector<float>                              zs;
+        MeshSlicingParamsEx                             params;
+        std::vector<ExPolygons>                         slices;
+        size_t                                          memory_usage;
+    };
+
+    // Hash of mesh content, cached for the meshes seen already.
+    uint64_t        mesh_hash(const std::shared_ptr<const TriangleMesh> &mesh);
+    // Find an entry with the same mesh content, zs and parameters. Called with m_mutex locked.
+    std::list<Entry>::iterator find_entry(const std::shared_ptr<const TriangleMesh> &mesh, uint64_t mesh_hash, const std::vector<float> &zs, const MeshSlicingParamsEx &params);
+
+    mutable std::mutex                                                      m_mutex;
+    // Most recently used first.
+    std::list<Entry>                                                        m_entries;
+    std::vector<std::pair<std::weak_ptr<const TriangleMesh>, uint64_t>>     m_mesh_hashes;
+    size_t                                                                  m_memory_usage { 0 };
+};
+
+} // namespace Slic3r
+
+#endif // slic3r_SliceCache_hpp_
@@ -16,6 +16,7 @@
 #include <libqhullcpp/Qhull.h>
 #include <libqhullcpp/QhullFacetList.h>
 #include <libqhullcpp/QhullVertexSet.h>
+#include <boost/container_hash/hash.hpp>
 #include <boost/log/trivial.hpp>
 #include <boost/nowide/cstdio.hpp>
 #include <boost/predef/other/endian.h>
@@ -1590,6 +1591,26 @@ float its_volume(const indexed_triangle_set &its)
     return volume;
 }
 
+uint64_t its_content_hash(const indexed_triangle_set &its)
+{
+    size_t seed = 0;
+    boost::hash_combine(seed, its.vertices.size());
+    boost::hash_combine(seed, its.indices.size());
+    auto hash_bytes = [&seed](const void *data, size_t size) {
+        const auto *p = reinterpret_cast<const unsigned char*>(data);
+        for (; size >= sizeof(uint64_t); p += sizeof(uint64_t), size -= sizeof(uint64_t)) {
+            uint64_t word;
+            memcpy(&word, p, sizeof(uint64_t));
+            boost::hash_combine(seed, word);
+        }
+        for (; size > 0; ++ p, -- size)
+            boost::hash_combine(seed, *p);
+    };
+    hash_bytes(its.vertices.data(), its.vertices.size() * sizeof(stl_vertex));
+    hash_bytes(its.indices.data(), its.indices.size() * sizeof(stl_triangle_vertex_indices));
+    return uint64_t(seed);
+}
+
 float its_average_edge_length(const indexed_triangle_set &its)
 {
     if (its.indices.empty())
@@ -345,6 +345,8 @@ inline stl_normal its_unnormalized_normal(const indexed_triangle_set &its,
 
 float its_volume(const indexed_triangle_set &its);
 float its_average_edge_length(const indexed_triangle_set &its);
+// Hash of the vertices and of the indices of a mesh. Meshes with the same hash are likely, but not guaranteed to be equal.
+uint64_t its_content_hash(const indexed_triangle_set &its);
 
 /// <summary>
 /// Merge one triangle mesh to another
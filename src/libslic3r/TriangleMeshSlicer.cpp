@@ -6,6 +6,7 @@
 #include <ankerl/unordered_dense.h>
 #include <oneapi/tbb/blocked_range.h>
 #include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/parallel_sort.h>
 #include <oneapi/tbb/scalable_allocator.h>
 #include <algorithm>
 #include <cmath>
@@ -209,13 +210,22 @@ inline Vec3f contour_point_to_v3f(const Point &pt, const T z)
         float(z));
 }
 
+// Same as coord_t(std::floor(v)) for v inside the range of coord_t, though it is inlined by the compiler
+// even if the target instruction set does not provide a rounding instruction (x86-64 without SSE4.1).
+template<typename T>
+inline coord_t floor_to_coord(const T v)
+{
+    const auto i = coord_t(v);
+    return i - coord_t(v < T(i));
+}
+
 // Convert 2D projection of an int32_t scaled coordinate into an unscaled 3D floating point coordinate (mesh vertex).
 template<typename Derived>
 inline Point v3f_scaled_to_contour_point(const Eigen::MatrixBase<Derived> &v)
 {
     static_assert(Derived::IsVectorAtCompileTime && int(Derived::SizeAtCompileTime) >= 2, "v3f_scaled_to_contour_point(): Not a 2D or 3D vector.");
     using T = typename Derived::Scalar;
-    return { coord_t(std::floor(v.x() + T(0.5))), coord_t(std::floor(v.y() + T(0.5))) };
+    return { floor_to_coord(v.x() + T(0.5)), floor_to_coord(v.y() + T(0.5)) };
 }
 
 // Return true, if the facet has been sliced and line_out has been filled.
@@ -513,6 +523,163 @@ static inline IntersectionLines slice_make_lines(
     return lines;
 }
 
+// Slice a facet, which is cut by the slicing plane in a general position: no vertex lies on the slicing plane.
+// above_mask has bit k set for the vertices above the slicing plane, at least one vertex is above and at least one below.
+// Produces the same intersection line as slice_facet(), with the same order of the edges and rounding of the intersection points,
+// though without the branches handling the vertices on the slicing plane.
+inline void slice_facet_general(
+    const float                         slice_z,
+    const stl_vertex                   *vertices,
+    const stl_triangle_vertex_indices  &indices,
+    const Vec3i                        &edge_ids,
+    const int                           idx_vertex_lowest,
+    const unsigned int                  above_mask,
+    IntersectionLine                   &line_out)
+{
+    assert(above_mask != 0 && above_mask != 7);
+    Point points[2];
+    int   edges[2];
+    int   num_points = 0;
+    for (int j = 0; j < 3; ++ j) {
+        const int k = (idx_vertex_lowest + j) % 3;
+        const int l = (k + 1) % 3;
+        if (((above_mask >> k) ^ (above_mask >> l)) & 1) {
+            // Sort the edge to give a consistent answer.
+            const stl_vertex *a = vertices + k;
+            const stl_vertex *b = vertices + l;
+            if (indices[k] > indices[l])
+                std::swap(a, b);
+            const double t = (double(slice_z) - double(a->z())) / (double(b->z()) - double(a->z()));
+            points[num_points] =
+                t <= 0. ? v3f_scaled_to_contour_point(*a) :
+                t >= 1. ? v3f_scaled_to_contour_point(*b) :
+                v3f_scaled_to_contour_point(a->template head<2>().template cast<double>() * (1. - t) + b->template head<2>().template cast<double>() * t + Vec2d(0.5, 0.5));
+            edges[num_points ++] = edge_ids(k);
+        }
+    }
+    assert(num_points == 2);
+    line_out.edge_type  = IntersectionLine::FacetEdgeType::General;
+    line_out.a          = points[1];
+    line_out.b          = points[0];
+    line_out.edge_a_id  = edges[1];
+    line_out.edge_b_id  = edges[0];
+}
+
+// Facets of MeshSlicingIndex active at the Z of a layer sweep. The Zs of the facet vertices are stored as separate arrays,
+// so that the facets are classified against the slicing plane in batches by a loop, which the compiler vectorizes.
+class ActiveFacets
+{
+public:
+    size_t size() const { return m_facets.size(); }
+
+    void add(uint32_t facet_idx, const std::vector<Vec3f> &vertices, const Vec3i &indices) {
+        m_facets.emplace_back(facet_idx);
+        m_z0.emplace_back(vertices[indices(0)].z());
+        m_z1.emplace_back(vertices[indices(1)].z());
+        m_z2.emplace_back(vertices[indices(2)].z());
+    }
+
+    // Remove facets ending below z.
+    void remove_below(const float z) {
+        size_t j = 0;
+        for (size_t i = 0; i < m_facets.size(); ++ i)
+            if (std::max(m_z0[i], std::max(m_z1[i], m_z2[i])) >= z) {
+                m_facets[j] = m_facets[i];
+                m_z0[j] = m_z0[i];
+                m_z1[j] = m_z1[i];
+                m_z2[j] = m_z2[i];
+                ++ j;
+            }
+        m_facets.resize(j);
+        m_z0.resize(j);
+        m_z1.resize(j);
+        m_z2.resize(j);
+    }
+
+    // Classify all active facets against plane z. Bits 0 to 2 are set for the vertices above the plane,
+    // bit 3 is set if any vertex lies on the plane.
+    void classify(const float z) {
+        const size_t n = m_facets.size();
+        m_classes.resize(n);
+        const float *z0 = m_z0.data();
+        const float *z1 = m_z1.data();
+        const float *z2 = m_z2.data();
+        uint8_t     *classes = m_classes.data();
+        for (size_t i = 0; i < n; ++ i)
+            classes[i] = uint8_t(int(z0[i] > z) | (int(z1[i] > z) << 1) | (int(z2[i] > z) << 2) |
+                (int(z0[i] == z || z1[i] == z || z2[i] == z) << 3));
+    }
+
+    uint32_t facet(size_t i)    const { return m_facets[i]; }
+    uint8_t  facet_class(size_t i) const { return m_classes[i]; }
+    static constexpr const uint8_t VertexOnPlane = 8;
+
+private:
+    std::vector<uint32_t> m_facets;
+    std::vector<float>    m_z0;
+    std::vector<float>    m_z1;
+    std::vector<float>    m_z2;
+    std::vector<uint8_t>  m_classes;
+};
+
+// Slice a mesh indexed by MeshSlicingIndex at multiple Zs.
+// Ranges of layers are sliced in parallel, each range sweeping the facets sorted by their minimum Z while maintaining
+// the set of facets active at the current Z, thus the lines are collected per layer without synchronization.
+// The active facets are classified against the slicing plane in a batch, facets cut in a general position are sliced
+// by slice_facet_general(), only the facets with a vertex on the slicing plane are sliced by the full slice_facet().
+template<typename ThrowOnCancel>
+static inline std::vector<IntersectionLines> slice_make_lines(
+    const MeshSlicingIndex                          &index,
+    const std::vector<float>                        &zs,
+    const ThrowOnCancel                              throw_on_cancel_fn)
+{
+    assert(std::is_sorted(zs.begin(), zs.end()));
+    std::vector<IntersectionLines> lines(zs.size(), IntersectionLines{});
+    const std::vector<Vec3f> &vertices = index.vertices();
+    const std::vector<Vec3i> &facets   = index.facets();
+    const std::vector<Vec3i> &edge_ids = index.facet_edge_ids();
+    const std::vector<float> &min_z    = index.facet_min_z();
+    const std::vector<float> &max_z    = index.facet_max_z();
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, zs.size(), 8),
+        [&index, &zs, &lines, &vertices, &facets, &edge_ids, &min_z, &max_z, throw_on_cancel_fn](const tbb::blocked_range<size_t> &range) {
+            // Facets starting below the first layer of this range and still active at its Z.
+            ActiveFacets active;
+            const float  z_first    = zs[range.begin()];
+            size_t       next_facet = std::upper_bound(min_z.begin(), min_z.end(), z_first) - min_z.begin();
+            index.visit_facets(z_first, z_first, [&active, &vertices, &facets](size_t facet_idx) { active.add(uint32_t(facet_idx), vertices, facets[facet_idx]); });
+            for (size_t layer_id = range.begin(); layer_id < range.end(); ++ layer_id) {
+                throw_on_cancel_fn();
+                const float z = zs[layer_id];
+                // Deactivate facets ending below z, activate facets starting at or below z.
+                active.remove_below(z);
+                for (; next_facet < min_z.size() && min_z[next_facet] <= z; ++ next_facet)
+                    if (max_z[next_facet] >= z)
+                        active.add(uint32_t(next_facet), vertices, facets[next_facet]);
+                active.classify(z);
+                IntersectionLines &layer_lines = lines[layer_id];
+                layer_lines.reserve(active.size());
+                for (size_t i = 0; i < active.size(); ++ i) {
+                    const uint8_t     facet_class = active.facet_class(i);
+                    const uint32_t    facet_idx   = active.facet(i);
+                    const Vec3i      &indices     = facets[facet_idx];
+                    const stl_vertex  facet_vertices[3] { vertices[indices(0)], vertices[indices(1)], vertices[indices(2)] };
+                    const int         idx_vertex_lowest = (facet_vertices[1].z() == min_z[facet_idx]) ? 1 : ((facet_vertices[2].z() == min_z[facet_idx]) ? 2 : 0);
+                    if (facet_class & ActiveFacets::VertexOnPlane) {
+                        IntersectionLine il;
+                        // Horizontal facets are not indexed.
+                        if (slice_facet(z, facet_vertices, indices, edge_ids[facet_idx], idx_vertex_lowest, false, 0, il) == FacetSliceType::Slicing) {
+                            assert(il.edge_type != IntersectionLine::FacetEdgeType::Horizontal);
+                            layer_lines.emplace_back(il);
+                        }
+                    } else if (facet_class != 0 && facet_class != 7)
+                        slice_facet_general(z, facet_vertices, indices, edge_ids[facet_idx], idx_vertex_lowest, facet_class, layer_lines.emplace_back());
+                }
+            }
+        });
+    return lines;
+}
+
 // For projecting triangle sets onto slice slabs.
 struct SlabLines {
     // Intersection lines of a slice with a triangle set, CCW oriented.
@@ -1930,6 +2097,55 @@ static std::vector<stl_vertex> transform_mesh_vertices_for_slicing(const typenam
     return out;
 }
 
+MeshSlicingIndex::MeshSlicingIndex(const indexed_triangle_set &mesh, const Transform3d &trafo, std::function<void()> throw_on_cancel) :
+    m_trafo(trafo), m_vertices(transform_mesh_vertices_for_slicing(mesh, trafo))
+{
+    std::vector<Vec3i> face_edge_ids = its_face_edge_ids(mesh, throw_on_cancel);
+    throw_on_cancel();
+
+    // Z span of all facets, horizontal facets are marked by an empty span.
+    std::vector<std::pair<float, float>> spans(mesh.indices.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, mesh.indices.size()), [this, &mesh, &spans](const tbb::blocked_range<size_t> &range) {
+        for (size_t facet_idx = range.begin(); facet_idx < range.end(); ++ facet_idx) {
+            const Vec3i &indices = mesh.indices[facet_idx];
+            const float  z0 = m_vertices[indices(0)].z(), z1 = m_vertices[indices(1)].z(), z2 = m_vertices[indices(2)].z();
+            spans[facet_idx] = { fminf(z0, fminf(z1, z2)), fmaxf(z0, fmaxf(z1, z2)) };
+        }
+    });
+    std::vector<int> order;
+    order.reserve(mesh.indices.size());
+    for (int facet_idx = 0; facet_idx < int(spans.size()); ++ facet_idx)
+        // Ignore horizontal triangles. Any valid horizontal triangle must have a vertical triangle connected, otherwise the part has zero volume.
+        if (spans[facet_idx].first != spans[facet_idx].second)
+            order.emplace_back(facet_idx);
+    tbb::parallel_sort(order.begin(), order.end(), [&spans](int l, int r) { return spans[l].first < spans[r].first || (spans[l].first == spans[r].first && l < r); });
+    throw_on_cancel();
+
+    m_facets.assign(order.size(), Vec3i::Zero());
+    m_facet_edge_ids.assign(order.size(), Vec3i::Zero());
+    m_facet_min_z.assign(order.size(), 0.f);
+    m_facet_max_z.assign(order.size(), 0.f);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, order.size()), [this, &mesh, &face_edge_ids, &spans, &order](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++ i) {
+            const int facet_idx = order[i];
+            m_facets[i]         = mesh.indices[facet_idx];
+            m_facet_edge_ids[i] = face_edge_ids[facet_idx];
+            m_facet_min_z[i]    = spans[facet_idx].first;
+            m_facet_max_z[i]    = spans[facet_idx].second;
+        }
+    });
+
+    m_block_max_z.assign((order.size() + BlockSize - 1) / BlockSize, std::numeric_limits<float>::lowest());
+    for (size_t i = 0; i < m_facet_max_z.size(); ++ i)
+        m_block_max_z[i / BlockSize] = std::max(m_block_max_z[i / BlockSize], m_facet_max_z[i]);
+}
+
+size_t MeshSlicingIndex::memory_usage() const
+{
+    return m_vertices.capacity() * sizeof(Vec3f) + (m_facets.capacity() + m_facet_edge_ids.capacity()) * sizeof(Vec3i) +
+        (m_facet_min_z.capacity() + m_facet_max_z.capacity() + m_block_max_z.capacity()) * sizeof(float);
+}
+
 template<AdditionalMeshInfo mesh_info = AdditionalMeshInfo::None>
 std::vector<typename PolygonsType<mesh_info>::type> slice_mesh(
     const typename IndexedTriangleSetType<mesh_info>::type &mesh,
@@ -2026,6 +2242,20 @@ std::vector<Polygons> slice_mesh(
     return slice_mesh<AdditionalMeshInfo::None>(mesh, zs, params, throw_on_cancel);
 }
 
+std::vector<Polygons> slice_mesh(
+    const MeshSlicingIndex           &index,
+    // Unscaled Zs
+    const std::vector<float>         &zs,
+    const MeshSlicingParams          &params,
+    std::function<void()>             throw_on_cancel)
+{
+    BOOST_LOG_TRIVIAL(debug) << "slice_mesh to polygons with a slicing index";
+
+    std::vector<IntersectionLines> lines = slice_make_lines(index, zs, throw_on_cancel);
+    throw_on_cancel();
+    return make_loops<AdditionalMeshInfo::None>(lines, params, throw_on_cancel);
+}
+
 std::vector<ColorPolygons> slice_mesh(
     const indexed_triangle_set_with_color &mesh,
     // Unscaled Zs
@@ -2127,22 +2357,64 @@ ColorPolygons slice_mesh(
     return slice_mesh<AdditionalMeshInfo::Color>(mesh, plane_z, params);
 }
 
-std::vector<ExPolygons> slice_mesh_ex(
-    const indexed_triangle_set       &mesh,
+// Slice the facets of a mesh indexed by MeshSlicingIndex at a single plane by slice_facet().
+static IntersectionLines slice_make_lines(const MeshSlicingIndex &index, const float plane_z)
+{
+    IntersectionLines         lines;
+    const std::vector<Vec3f> &vertices = index.vertices();
+    index.visit_facets(plane_z, plane_z, [&index, &vertices, plane_z, &lines](size_t facet_idx) {
+        const Vec3i &indices = index.facets()[facet_idx];
+        stl_vertex   facet_vertices[3] { vertices[indices(0)], vertices[indices(1)], vertices[indices(2)] };
+        const float  min_z = index.facet_min_z()[facet_idx];
+        int          idx_vertex_lowest = (facet_vertices[1].z() == min_z) ? 1 : ((facet_vertices[2].z() == min_z) ? 2 : 0);
+        IntersectionLine il;
+        if (slice_facet(plane_z, facet_vertices, indices, index.facet_edge_ids()[facet_idx], idx_vertex_lowest, false, 0, il) == FacetSliceType::Slicing) {
+            assert(il.edge_type != IntersectionLine::FacetEdgeType::Horizontal);
+            lines.emplace_back(il);
+        }
+    });
+    return lines;
+}
+
+Polygons slice_mesh(
+    const MeshSlicingIndex           &index,
+    // Unscaled Zs
+    const float                       plane_z,
+    const MeshSlicingParams          &params)
+{
+    std::vector<IntersectionLines> lines(1, slice_make_lines(index, plane_z));
+    std::vector<Polygons> layers = make_loops<AdditionalMeshInfo::None>(lines, params, [](){});
+    assert(layers.size() == 1);
+    return layers.front();
+}
+
+std::vector<std::vector<MeshSlicingLine>> slice_mesh_lines(
+    const MeshSlicingIndex           &index,
+    // Unscaled Zs
     const std::vector<float>         &zs,
-    const MeshSlicingParamsEx        &params,
-    std::function<void()>             throw_on_cancel)
+    bool                              batched)
 {
-    std::vector<Polygons> layers_p;
-    {
-        MeshSlicingParams slicing_params(params);
-        if (params.mode == MeshSlicingParams::SlicingMode::PositiveLargestContour)
-            slicing_params.mode = MeshSlicingParams::SlicingMode::Positive;
-        if (params.mode_below == MeshSlicingParams::SlicingMode::PositiveLargestContour)
-            slicing_params.mode_below = MeshSlicingParams::SlicingMode::Positive;
-        layers_p = slice_mesh(mesh, zs, slicing_params, throw_on_cancel);
+    std::vector<IntersectionLines> lines;
+    if (batched)
+        lines = slice_make_lines(index, zs, [](){});
+    else
+        for (const float z : zs)
+            lines.emplace_back(slice_make_lines(index, z));
+    std::vector<std::vector<MeshSlicingLine>> out;
+    out.reserve(lines.size());
+    for (const IntersectionLines &layer_lines : lines) {
+        std::vector<MeshSlicingLine> &layer = out.emplace_back();
+        layer.reserve(layer_lines.size());
+        for (const IntersectionLine &il : layer_lines)
+            layer.push_back({ il.a, il.b, il.a_id, il.b_id, il.edge_a_id, il.edge_b_id, int(il.edge_type) });
+        std::sort(layer.begin(), layer.end());
     }
-    
+    return out;
+}
+
+// Convert the sliced polygons to expolygons for slice_mesh_ex().
+static std::vector<ExPolygons> layers_make_expolygons(std::vector<Polygons> &&layers_p, const MeshSlicingParamsEx &params, std::function<void()> throw_on_cancel)
+{
 //    BOOST_LOG_TRIVIAL(debug) << "slice_mesh make_expolygons in parallel - start";
     std::vector<ExPolygons> layers(layers_p.size(), ExPolygons{});
     tbb::parallel_for(
@@ -2206,6 +2478,35 @@ std::vector<ExPolygons> slice_mesh_ex(
     return layers;
 }
 
+// Slicing parameters for slice_mesh(), the PositiveLargestContour mode is applied by make_expolygons().
+static MeshSlicingParams slice_mesh_ex_params(const MeshSlicingParamsEx &params)
+{
+    MeshSlicingParams slicing_params(params);
+    if (params.mode == MeshSlicingParams::SlicingMode::PositiveLargestContour)
+        slicing_params.mode = MeshSlicingParams::SlicingMode::Positive;
+    if (params.mode_below == MeshSlicingParams::SlicingMode::PositiveLargestContour)
+        slicing_params.mode_below = MeshSlicingParams::SlicingMode::Positive;
+    return slicing_params;
+}
+
+std::vector<ExPolygons> slice_mesh_ex(
+    const indexed_triangle_set       &mesh,
+    const std::vector<float>         &zs,
+    const MeshSlicingParamsEx        &params,
+    std::function<void()>             throw_on_cancel)
+{
+    return layers_make_expolygons(slice_mesh(mesh, zs, slice_mesh_ex_params(params), throw_on_cancel), params, throw_on_cancel);
+}
+
+std::vector<ExPolygons> slice_mesh_ex(
+    const MeshSlicingIndex           &index,
+    const std::vector<float>         &zs,
+    const MeshSlicingParamsEx        &params,
+    std::function<void()>             throw_on_cancel)
+{
+    return layers_make_expolygons(slice_mesh(index, zs, slice_mesh_ex_params(params), throw_on_cancel), params, throw_on_cancel);
+}
+
 // Slice a triangle set with a set of Z slabs (thick layers).
 // The effect is similar to producing the usual top / bottom layers from a sliced mesh by 
 // subtracting layer[i] from layer[i - 1] for the top surfaces resp.
@@ -7,8 +7,10 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <algorithm>
 #include <functional>
 #include <vector>
+#include <tuple>
 #include <cinttypes>
 #include <cstddef>
 
@@ -63,6 +65,56 @@ struct MeshSlicingParamsEx : public MeshSlicingParams
     double        resolution { 0 };
 };
 
+// Index of the facets of a triangle mesh for repeated slicing. The mesh vertices are transformed for slicing once
+// (scaled in XY, unscaled in Z) and the facets are sorted by their minimum Z, so that slicing sweeps just the facets active
+// at the sliced Zs. Building the index is the only pass over the whole mesh, the index then may be used to slice the mesh
+// at different Zs or for different purposes without touching the facets outside of the sliced Z range.
+// Horizontal facets are not indexed, they are never sliced.
+class MeshSlicingIndex
+{
+public:
+    MeshSlicingIndex() = default;
+    MeshSlicingIndex(const indexed_triangle_set &mesh, const Transform3d &trafo, std::function<void()> throw_on_cancel = []{});
+
+    // Transformation of the mesh the index was built with, it replaces MeshSlicingParams::trafo when slicing with the index.
+    const Transform3d&              trafo()         const { return m_trafo; }
+    size_t                          num_facets()    const { return m_facet_min_z.size(); }
+    bool                            empty()         const { return m_facet_min_z.empty(); }
+    size_t                          memory_usage()  const;
+
+    // Transformed mesh vertices, scaled in XY, unscaled in Z.
+    const std::vector<Vec3f>&       vertices()      const { return m_vertices; }
+    // Vertex indices, edge identifiers and Z span of the facets sorted by the minimum Z of the facets.
+    const std::vector<Vec3i>&       facets()        const { return m_facets; }
+    const std::vector<Vec3i>&       facet_edge_ids()const { return m_facet_edge_ids; }
+    const std::vector<float>&       facet_min_z()   const { return m_facet_min_z; }
+    const std::vector<float>&       facet_max_z()   const { return m_facet_max_z; }
+
+    // Call visitor(facet_idx) for all facets with facet_min_z() <= z_max and facet_max_z() >= z_min, in the order of facet_min_z().
+    template<typename Visitor>
+    void                            visit_facets(float z_min, float z_max, Visitor visitor) const {
+        const size_t end = std::upper_bound(m_facet_min_z.begin(), m_facet_min_z.end(), z_max) - m_facet_min_z.begin();
+        for (size_t block = 0; block * BlockSize < end; ++ block)
+            // Skip the blocks of facets ending below z_min.
+            if (m_block_max_z[block] >= z_min)
+                for (size_t i = block * BlockSize; i < std::min(end, (block + 1) * BlockSize); ++ i)
+                    if (m_facet_max_z[i] >= z_min)
+                        visitor(i);
+    }
+
+private:
+    // Maximum Z of facets is tracked for blocks of BlockSize facets to quickly skip the facets below the sliced Z range.
+    static constexpr const size_t   BlockSize = 64;
+
+    Transform3d                     m_trafo { Transform3d::Identity() };
+    std::vector<Vec3f>              m_vertices;
+    std::vector<Vec3i>              m_facets;
+    std::vector<Vec3i>              m_facet_edge_ids;
+    std::vector<float>              m_facet_min_z;
+    std::vector<float>              m_facet_max_z;
+    std::vector<float>              m_block_max_z;
+};
+
 // All the following slicing functions shall produce consistent results with the same mesh, same transformation matrix and slicing parameters.
 // Namely, slice_mesh_slabs() shall produce consistent results with slice_mesh() and slice_mesh_ex() in the sense, that projections made by 
 // slice_mesh_slabs() shall fall onto slicing planes produced by slice_mesh().
@@ -86,23 +138,68 @@ std::vector<ColorPolygons>      slice_mesh(
     const MeshSlicingParams               &params,
     std::function<void()>                  throw_on_cancel = []{});
 
+// Slice a mesh indexed by MeshSlicingIndex, MeshSlicingParams::trafo is ignored, the mesh is sliced with MeshSlicingIndex::trafo().
+std::vector<Polygons>           slice_mesh(
+    const MeshSlicingIndex           &index,
+    const std::vector<float>         &zs,
+    const MeshSlicingParams          &params,
+    std::function<void()>             throw_on_cancel = []{});
+
 // Specialized version for a single slicing plane only, running on a single thread.
 Polygons                        slice_mesh(
     const indexed_triangle_set       &mesh,
     float                             plane_z,
     const MeshSlicingParams          &params);
 
+Polygons                        slice_mesh(
+    const MeshSlicingIndex           &index,
+    float                             plane_z,
+    const MeshSlicingParams          &params);
+
 ColorPolygons                   slice_mesh(
     const indexed_triangle_set_with_color &mesh,
     float                                  plane_z,
     const MeshSlicingParams               &params);
 
+// Intersection line of a facet with a slicing plane, exported for the unit tests.
+struct MeshSlicingLine
+{
+    Point a;
+    Point b;
+    // Vertex indices of the line end points, or -1 if the end point lies on a mesh edge.
+    int   a_id;
+    int   b_id;
+    // Mesh edges of the line end points, or -1 if the end point is a vertex.
+    int   edge_a_id;
+    int   edge_b_id;
+    // Type of the facet edge (general, top, bottom...).
+    int   edge_type;
+
+    auto tie() const { return std::make_tuple(a.x(), a.y(), b.x(), b.y(), a_id, b_id, edge_a_id, edge_b_id, edge_type); }
+    bool operator==(const MeshSlicingLine &rhs) const { return this->tie() == rhs.tie(); }
+    bool operator<(const MeshSlicingLine &rhs) const { return this->tie() < rhs.tie(); }
+};
+
+// Intersection lines of the facets of a mesh indexed by MeshSlicingIndex with the planes at zs, sorted for each plane.
+// If batched, the lines are produced by the sweep slicing the index at multiple Zs, otherwise by slice_facet() plane by plane.
+// Exported for the unit tests, to verify that both produce the same lines.
+std::vector<std::vector<MeshSlicingLine>> slice_mesh_lines(
+    const MeshSlicingIndex           &index,
+    const std::vector<float>         &zs,
+    bool                              batched);
+
 std::vector<ExPolygons>         slice_mesh_ex(
     const indexed_triangle_set       &mesh,
     const std::vector<float>         &zs,
     const MeshSlicingParamsEx        &params,
     std::function<void()>             throw_on_cancel = []{});
 
+std::vector<ExPolygons>         slice_mesh_ex(
+    const MeshSlicingIndex           &index,
+    const std::vector<float>         &zs,
+    const MeshSlicingParamsEx        &params,
+    std::function<void()>             throw_on_cancel = []{});
+
 inline std::vector<ExPolygons>  slice_mesh_ex(
     const indexed_triangle_set       &mesh,
     const std::vector<float>         &zs,
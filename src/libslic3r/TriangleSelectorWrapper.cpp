@@ -10,7 +10,7 @@
 #include <vector>
 
 #include "admesh/stl.h"
-#include "libslic3r/AABBTreeIndirect.hpp"
+#include "libslic3r/AABBTreeWide.hpp"
 #include "libslic3r/TriangleMesh.hpp"
 #include "libslic3r/TriangleSelector.hpp"
 
@@ -18,7 +18,7 @@ namespace Slic3r {
 
 TriangleSelectorWrapper::TriangleSelectorWrapper(const TriangleMesh &mesh, const Transform3d& mesh_transform) :
         mesh(mesh), mesh_transform(mesh_transform), selector(mesh), triangles_tree(
-                AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(mesh.its.vertices, mesh.its.indices)) {
+                AABBTreeIndirect::build_wide_aabb_tree_over_indexed_triangle_set<4>(mesh.its.vertices, mesh.its.indices)) {
 }
 
 void TriangleSelectorWrapper::enforce_spot(const Vec3f &point, const Vec3f &origin, float radius) {
@@ -7,7 +7,7 @@
 
 #include "TriangleSelector.hpp"
 #include "Model.hpp"
-#include "AABBTreeIndirect.hpp"
+#include "AABBTreeWide.hpp"
 #include "libslic3r/Point.hpp"
 
 namespace Slic3r {
@@ -24,7 +24,7 @@ public:
     const TriangleMesh &mesh;
     const Transform3d& mesh_transform;
     TriangleSelector selector;
-    AABBTreeIndirect::Tree<3, float> triangles_tree;
+    AABBTreeIndirect::WideTree4f triangles_tree;
 
     TriangleSelectorWrapper(const TriangleMesh &mesh, const Transform3d& mesh_transform);
 
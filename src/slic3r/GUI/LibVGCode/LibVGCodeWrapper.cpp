@@ -17,6 +17,7 @@
 #include "libslic3r/Exception.hpp"
 #include "libslic3r/ExtrusionEntity.hpp"
 #include "libslic3r/ExtrusionEntityCollection.hpp"
+#include "libslic3r/GCode/CompactMoves.hpp"
 #include "libslic3r/GCode/WipeTower.hpp"
 #include "libslic3r/Layer.hpp"
 #include "libslic3r/LayerRegion.hpp"
@@ -191,47 +192,57 @@ GCodeInputData convert(const Slic3r::GCodeProcessorResult& result, const std::ve
         ret.color_print_colors.emplace_back(convert(color));
     }
 
-    const std::vector<Slic3r::GCodeProcessorResult::MoveVertex>& moves = result.moves;
-    ret.vertices.reserve(2 * moves.size());
-    for (size_t i = 1; i < moves.size(); ++i) {
-        const Slic3r::GCodeProcessorResult::MoveVertex& curr = moves[i];
-        const Slic3r::GCodeProcessorResult::MoveVertex& prev = moves[i - 1];
-        const EMoveType curr_type = convert(curr.type);
-        const EOptionType option_type = move_type_to_option(curr_type);
-        if (option_type == EOptionType::COUNT || option_type == EOptionType::Travels || option_type == EOptionType::Wipes) {
-            if (ret.vertices.empty() || prev.type != curr.type || prev.extrusion_role != curr.extrusion_role) {
-                // to allow libvgcode to properly detect the start/end of a path we need to add a 'phantom' vertex
-                // equal to the current one with the exception of the position, which should match the previous move position,
-                // and the times, which are set to zero
+    // The moves are either stored as an array of structures or compacted, which are decoded sequentially.
+    auto convert_moves = [&](auto it, auto end) {
+        if (it == end)
+            return;
+        // Copy of the previous move, the compacted moves iterator owns the decoded move.
+        Slic3r::GCodeProcessorResult::MoveVertex prev = *it;
+        for (++ it; it != end; ++ it) {
+            const Slic3r::GCodeProcessorResult::MoveVertex& curr = *it;
+            const EMoveType curr_type = convert(curr.type);
+            const EOptionType option_type = move_type_to_option(curr_type);
+            if (option_type == EOptionType::COUNT || option_type == EOptionType::Travels || option_type == EOptionType::Wipes) {
+                if (ret.vertices.empty() || prev.type != curr.type || prev.extrusion_role != curr.extrusion_role) {
+                    // to allow libvgcode to properly detect the start/end of a path we need to add a 'phantom' vertex
+                    // equal to the current one with the exception of the position, which should match the previous move position,
+                    // and the times, which are set to zero
 #if VGCODE_ENABLE_COG_AND_TOOL_MARKERS
-                const libvgcode::PathVertex vertex = { convert(prev.position), curr.height, curr.width, curr.feedrate, prev.actual_feedrate,
-                    curr.mm3_per_mm, curr.fan_speed, curr.temperature, 0.0f, convert(curr.extrusion_role), curr_type,
-                    static_cast<uint32_t>(curr.gcode_id), static_cast<uint32_t>(curr.layer_id),
-                    static_cast<uint8_t>(curr.extruder_id), static_cast<uint8_t>(curr.cp_color_id), { 0.0f, 0.0f } };
+                    const libvgcode::PathVertex vertex = { convert(prev.position), curr.height, curr.width, curr.feedrate, prev.actual_feedrate,
+                        curr.mm3_per_mm, curr.fan_speed, curr.temperature, 0.0f, convert(curr.extrusion_role), curr_type,
+                        static_cast<uint32_t>(curr.gcode_id), static_cast<uint32_t>(curr.layer_id),
+                        static_cast<uint8_t>(curr.extruder_id), static_cast<uint8_t>(curr.cp_color_id), { 0.0f, 0.0f } };
 #else
-              const libvgcode::PathVertex vertex = { convert(prev.position), curr.height, curr.width, curr.feedrate, prev.actual_feedrate,
-                    curr.mm3_per_mm, curr.fan_speed, curr.temperature, convert(curr.extrusion_role), curr_type,
-                    static_cast<uint32_t>(curr.gcode_id), static_cast<uint32_t>(curr.layer_id),
-                    static_cast<uint8_t>(curr.extruder_id), static_cast<uint8_t>(curr.cp_color_id), { 0.0f, 0.0f } };
+                  const libvgcode::PathVertex vertex = { convert(prev.position), curr.height, curr.width, curr.feedrate, prev.actual_feedrate,
+                        curr.mm3_per_mm, curr.fan_speed, curr.temperature, convert(curr.extrusion_role), curr_type,
+                        static_cast<uint32_t>(curr.gcode_id), static_cast<uint32_t>(curr.layer_id),
+                        static_cast<uint8_t>(curr.extruder_id), static_cast<uint8_t>(curr.cp_color_id), { 0.0f, 0.0f } };
 #endif // VGCODE_ENABLE_COG_AND_TOOL_MARKERS
-                ret.vertices.emplace_back(vertex);
+                    ret.vertices.emplace_back(vertex);
+                }
             }
-        }
 
 #if VGCODE_ENABLE_COG_AND_TOOL_MARKERS
-        const libvgcode::PathVertex vertex = { convert(curr.position), curr.height, curr.width, curr.feedrate, curr.actual_feedrate,
-            curr.mm3_per_mm, curr.fan_speed, curr.temperature,
-            result.filament_densities[curr.extruder_id] * curr.mm3_per_mm * (curr.position - prev.position).norm(),
-            convert(curr.extrusion_role), curr_type, static_cast<uint32_t>(curr.gcode_id), static_cast<uint32_t>(curr.layer_id),
-            static_cast<uint8_t>(curr.extruder_id), static_cast<uint8_t>(curr.cp_color_id), curr.time };
+            const libvgcode::PathVertex vertex = { convert(curr.position), curr.height, curr.width, curr.feedrate, curr.actual_feedrate,
+                curr.mm3_per_mm, curr.fan_speed, curr.temperature,
+                result.filament_densities[curr.extruder_id] * curr.mm3_per_mm * (curr.position - prev.position).norm(),
+                convert(curr.extrusion_role), curr_type, static_cast<uint32_t>(curr.gcode_id), static_cast<uint32_t>(curr.layer_id),
+                static_cast<uint8_t>(curr.extruder_id), static_cast<uint8_t>(curr.cp_color_id), curr.time };
 #else
-        const libvgcode::PathVertex vertex = { convert(curr.position), curr.height, curr.width, curr.feedrate, curr.actual_feedrate,
-            curr.mm3_per_mm, curr.fan_speed, curr.temperature, convert(curr.extrusion_role), curr_type,
-            static_cast<uint32_t>(curr.gcode_id), static_cast<uint32_t>(curr.layer_id),
-            static_cast<uint8_t>(curr.extruder_id), static_cast<uint8_t>(curr.cp_color_id), curr.time };
+            const libvgcode::PathVertex vertex = { convert(curr.position), curr.height, curr.width, curr.feedrate, curr.actual_feedrate,
+                curr.mm3_per_mm, curr.fan_speed, curr.temperature, convert(curr.extrusion_role), curr_type,
+                static_cast<uint32_t>(curr.gcode_id), static_cast<uint32_t>(curr.layer_id),
+                static_cast<uint8_t>(curr.extruder_id), static_cast<uint8_t>(curr.cp_color_id), curr.time };
 #endif // VGCODE_ENABLE_COG_AND_TOOL_MARKERS
-        ret.vertices.emplace_back(vertex);
-    }
+            ret.vertices.emplace_back(vertex);
+            prev = curr;
+        }
+    };
+    ret.vertices.reserve(2 * result.moves_count());
+    if (result.compact_moves)
+        convert_moves(result.compact_moves->begin(), result.compact_moves->end());
+    else
+        convert_moves(result.moves.begin(), result.moves.end());
     ret.vertices.shrink_to_fit();
 
     ret.spiral_vase_mode = result.spiral_vase_mode;
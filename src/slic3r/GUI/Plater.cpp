@@ -4560,6 +4560,7 @@ void Plater::load_gcode(const wxString& filename)
 
     // process gcode
     GCodeProcessor processor;
+    processor.enable_compact_moves(true);
     try
     {
         p->notification_manager->push_download_progress_notification("Loading...", []() { return false; });
@@ -0,0 +1,54 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark_all.hpp>
+#include "test_data.hpp"
+
+#include "libslic3r/Geometry.hpp"
+#include "libslic3r/TriangleMesh.hpp"
+#include "libslic3r/TriangleMeshSlicer.hpp"
+
+using namespace Slic3r;
+
+static std::vector<float> slicing_zs(const indexed_triangle_set &its, const Transform3d &trafo, float layer_height)
+{
+    const BoundingBoxf3 bbox = bounding_box(its).transformed(trafo);
+    std::vector<float>  zs;
+    for (double z = bbox.min.z() + 0.5 * layer_height; z < bbox.max.z(); z += layer_height)
+        zs.emplace_back(float(z));
+    return zs;
+}
+
+TEST_CASE("Slicing benchmarks", "[TriangleMeshSlicer][.Benchmarks]") {
+    const Transform3d trafo = Geometry::assemble_transform(Vec3d::Zero(), Vec3d(0.3, 0.2, 0.1));
+
+    std::vector<TriangleMesh> test_meshes;
+    for (const auto &[mesh, name] : Test::mesh_names)
+        test_meshes.emplace_back(Test::mesh(mesh));
+    BENCHMARK("Slice test meshes") {
+        size_t num_polygons = 0;
+        for (const TriangleMesh &mesh : test_meshes) {
+            MeshSlicingParamsEx params;
+            params.trafo = trafo;
+            for (const ExPolygons &layer : slice_mesh_ex(mesh.its, slicing_zs(mesh.its, trafo, 0.1f), params))
+                num_polygons += layer.size();
+        }
+        return num_polygons;
+    };
+
+    // High polygon count mesh.
+    const indexed_triangle_set sphere = its_make_sphere(25., PI / 720.);
+    const std::vector<float>   zs     = slicing_zs(sphere, trafo, 0.05f);
+    MeshSlicingParams          params(trafo);
+
+    BENCHMARK("Build slicing index of a high poly sphere") {
+        return MeshSlicingIndex(sphere, trafo);
+    };
+
+    const MeshSlicingIndex index(sphere, trafo);
+    BENCHMARK("Slice a high poly sphere with a slicing index") {
+        return slice_mesh(index, zs, params);
+    };
+
+    BENCHMARK("Slice a high poly sphere") {
+        return slice_mesh(sphere, zs, params);
+    };
+}
@@ -1,9 +1,32 @@
 #include <catch2/catch_test_macros.hpp>
 
+#include <boost/filesystem.hpp>
+#include <boost/nowide/cstdio.hpp>
+
+#include "libslic3r/GCode.hpp"
+#include "libslic3r/GCodeReader.hpp"
+
 #include "test_data.hpp"
 
 using namespace Slic3r;
 
+// Travel moves of a processed print exported with or without the avoid crossing perimeters boundaries prepared ahead of the G-code generator.
+static std::vector<std::string> travels(Print &print, bool prepare_boundaries)
+{
+    const std::string path = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string();
+    GCodeGenerator gcodegen(&print);
+    gcodegen.enable_avoid_crossing_perimeters_preparation(prepare_boundaries);
+    gcodegen.do_export(&print, path.c_str());
+    std::vector<std::string> out;
+    GCodeReader parser;
+    parser.parse_file(path, [&out](GCodeReader &, const GCodeReader::GCodeLine &line) {
+        if (line.travel())
+            out.emplace_back(line.raw());
+    });
+    boost::nowide::remove(path.c_str());
+    return out;
+}
+
 SCENARIO("Avoid crossing perimeters", "[AvoidCrossingPerimeters]") {
 	WHEN("Two 20mm cubes sliced") {
         std::string gcode = Slic3r::Test::slice(
@@ -13,4 +36,35 @@ SCENARIO("Avoid crossing perimeters", "[AvoidCrossingPerimeters]") {
             REQUIRE(! gcode.empty());
         }
     }
+	WHEN("Objects with holes sliced") {
+        std::string gcode = Slic3r::Test::slice(
+    	    { Slic3r::Test::TestMesh::cube_with_hole, Slic3r::Test::TestMesh::two_hollow_squares, Slic3r::Test::TestMesh::ipadstand },
+            { { "avoid_crossing_perimeters", true } });
+        THEN("gcode not empty") {
+            REQUIRE(! gcode.empty());
+        }
+    }
+	WHEN("Two objects with holes sliced and printed one by one") {
+        std::string gcode = Slic3r::Test::slice(
+    	    { Slic3r::Test::TestMesh::cube_with_hole, Slic3r::Test::TestMesh::cube_with_hole },
+            { { "avoid_crossing_perimeters", true }, { "complete_objects", true } });
+        THEN("gcode not empty") {
+            REQUIRE(! gcode.empty());
+        }
+    }
+	WHEN("Objects with holes sliced with and without the boundaries prepared ahead") {
+        for (bool complete_objects : { false, true }) {
+            Print print;
+            Model model;
+            Slic3r::Test::init_print({ Slic3r::Test::TestMesh::cube_with_hole, Slic3r::Test::TestMesh::cube_with_hole }, print, model,
+                { { "avoid_crossing_perimeters", true }, { "complete_objects", complete_objects } });
+            print.process();
+            const std::vector<std::string> prepared     = travels(print, true);
+            const std::vector<std::string> not_prepared = travels(print, false);
+            THEN("travels are the same") {
+                REQUIRE(! prepared.empty());
+                REQUIRE(prepared == not_prepared);
+            }
+        }
+    }
 }
@@ -74,7 +74,7 @@ void check_retraction(const std::string &gcode, double offset = 0.0) {
                     retracted[extruder_id] += line.e();
                 }
                 if (line.has_e() && line.e() > 0) {
-                    INFO("Line: " + line.raw());
+                    INFO("Line: " + std::string(line.raw()));
                     if (there_is_unretract.count(extruder_id) == 0) {
                         there_is_unretract.insert(extruder_id);
                         REQUIRE(retracted[extruder_id] + offset + line.e() == Approx(0.0));
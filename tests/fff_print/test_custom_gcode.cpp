@@ -151,9 +151,9 @@ SCENARIO("Custom G-code", "[CustomGCode]")
             std::vector<int> change;
             parser.parse_buffer(gcode, [&before, &change](Slic3r::GCodeReader &self, const Slic3r::GCodeReader::GCodeLine &line){
                 int d;
-                if (sscanf(line.raw().c_str(), ";BEFORE %d", &d) == 1)
+                if (sscanf(std::string(line.raw()).c_str(), ";BEFORE %d", &d) == 1)
                     before.emplace_back(d);
-                else if (sscanf(line.raw().c_str(), ";CHANGE %d", &d) == 1) {
+                else if (sscanf(std::string(line.raw()).c_str(), ";CHANGE %d", &d) == 1) {
                     change.emplace_back(d);
                     if (d != before.back())
                         throw std::runtime_error("inconsistent layer_num before and after layer change");
@@ -1,4 +1,5 @@
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
 
 #include <numeric>
 #include <sstream>
@@ -6,6 +7,7 @@
 #include "libslic3r/libslic3r.h"
 
 #include "libslic3r/ClipperUtils.hpp"
+#include "libslic3r/Fill/FillAdaptive.hpp"
 #include "libslic3r/Flow.hpp"
 #include "libslic3r/Layer.hpp"
 #include "libslic3r/Geometry.hpp"
@@ -13,10 +15,14 @@
 #include "libslic3r/Point.hpp"
 #include "libslic3r/Print.hpp"
 #include "libslic3r/SVG.hpp"
+#include "libslic3r/TriangleMesh.hpp"
+
+#include <oneapi/tbb/global_control.h>
 
 #include "test_data.hpp"
 
 using namespace Slic3r;
+using namespace Catch;
 using namespace std::literals;
 
 bool test_if_solid_surface_filled(const ExPolygon& expolygon, double flow_spacing, double angle = 0, double density = 1.0);
@@ -197,6 +203,76 @@ TEST_CASE("Fill: Pattern Path Length", "[Fill]") {
     }
 }
 
+TEST_CASE("Adaptive cubic infill octree", "[Fill]") {
+    const indexed_triangle_set mesh = its_make_sphere(20., PI / 20.);
+    // Overhang triangles of an internal bridge.
+    const std::vector<Vec3d>   overhangs { { -5., -5., 0. }, { 5., -5., 0. }, { 0., 5., 0. } };
+    const coordf_t             line_spacing = 1.;
+    const FillAdaptive::OctreePtr octree = FillAdaptive::build_octree(mesh, overhangs, line_spacing, false);
+    const std::vector<std::pair<int, Vec3d>> cubes = FillAdaptive::octree_cubes(*octree);
+    REQUIRE(cubes.size() > 8);
+
+    SECTION("The cubes of the subtrees built in parallel enclose the mesh and the overhangs") {
+        const Eigen::Quaterniond to_octree = FillAdaptive::transform_to_octree();
+        const double             radius    = 20.;
+        // The triangles of the sphere tessellated by PI / 20 steps are closer to its center than its vertices, but not by much.
+        const double             min_radius = radius * std::cos(PI / 10.);
+        // Centers of the parents of the current cube, axis aligned in the coordinate system of the octree.
+        std::vector<Vec3d>                     parents;
+        // Centers and half edges of the smallest cubes.
+        std::vector<std::pair<Vec3d, double>> leaves;
+        int                                    max_depth = 0;
+        for (const auto &[depth, world_center] : cubes) {
+            const Vec3d center = to_octree * world_center;
+            parents.resize(depth);
+            parents.emplace_back(center);
+            if (depth == 0)
+                continue;
+            // A child cube is centered at the center of its parent offset by its half edge along each axis.
+            const Vec3d  offset    = (center - parents[depth - 1]).cwiseAbs();
+            const double half_edge = offset.maxCoeff();
+            REQUIRE(offset.minCoeff() == Approx(half_edge));
+            // The cube intersects the sphere or the bounding box of the overhang triangle.
+            const Vec3d  nearest   = (center.cwiseAbs() - Vec3d(half_edge, half_edge, half_edge)).cwiseMax(0.);
+            const Vec3d  farthest  = center.cwiseAbs() + Vec3d(half_edge, half_edge, half_edge);
+            const bool   sphere    = nearest.norm() <= radius + EPSILON && farthest.norm() >= min_radius;
+            const bool   overhang  = std::abs(center.z()) <= half_edge + EPSILON &&
+                std::abs(center.x()) <= 5. + half_edge + EPSILON && std::abs(center.y()) <= 5. + half_edge + EPSILON;
+            REQUIRE((sphere || overhang));
+            if (depth > max_depth) {
+                max_depth = depth;
+                leaves.clear();
+            }
+            if (depth == max_depth)
+                leaves.emplace_back(center, half_edge);
+        }
+        // The smallest cubes have twice the edge of the line spacing and they cover all the vertices of the mesh.
+        REQUIRE(! leaves.empty());
+        for (const std::pair<Vec3d, double> &leaf : leaves)
+            REQUIRE(leaf.second == Approx(line_spacing));
+        for (const Vec3f &vertex : mesh.vertices)
+            REQUIRE(std::any_of(leaves.begin(), leaves.end(), [&vertex](const std::pair<Vec3d, double> &leaf) {
+                return (vertex.cast<double>() - leaf.first).cwiseAbs().maxCoeff() <= leaf.second + EPSILON;
+            }));
+    }
+
+    SECTION("The octree is reused if built from the same mesh with the same line spacing") {
+        FillAdaptive::OctreePtr previous = FillAdaptive::build_octree(mesh, overhangs, line_spacing, false);
+        const FillAdaptive::Octree *previous_ptr = previous.get();
+        FillAdaptive::OctreePtr reused = FillAdaptive::build_octree(mesh, overhangs, line_spacing, false, std::move(previous));
+        REQUIRE(reused.get() == previous_ptr);
+        REQUIRE(FillAdaptive::octree_cubes(*reused) == cubes);
+    }
+
+    SECTION("The octree is rebuilt if the line spacing changes") {
+        FillAdaptive::OctreePtr previous = FillAdaptive::build_octree(mesh, overhangs, line_spacing, false);
+        FillAdaptive::OctreePtr rebuilt  = FillAdaptive::build_octree(mesh, overhangs, 2. * line_spacing, false, std::move(previous));
+        const std::vector<std::pair<int, Vec3d>> rebuilt_cubes = FillAdaptive::octree_cubes(*rebuilt);
+        REQUIRE(rebuilt_cubes != cubes);
+        REQUIRE(rebuilt_cubes == FillAdaptive::octree_cubes(*FillAdaptive::build_octree(mesh, overhangs, 2. * line_spacing, false)));
+    }
+}
+
 SCENARIO("Infill does not exceed perimeters", "[Fill]") 
 {
     auto test = [](const std::string_view pattern) {
@@ -433,6 +509,66 @@ SCENARIO("Combine infill", "[Fill]")
         }
     }
         
+    WHEN("infill_every_layers differs between regions") {
+        // The left half of the cube is overridden by a modifier combining the infill of each two layers, the rest of each three layers.
+        Model        model;
+        ModelObject *object = model.add_object();
+        object->add_volume(Test::mesh(Test::TestMesh::cube_20x20x20));
+        ModelVolume *modifier = object->add_volume(Test::mesh(Test::TestMesh::cube_20x20x20), ModelVolumeType::PARAMETER_MODIFIER);
+        modifier->set_scaling_factor(Vec3d(0.5, 1., 1.));
+        DynamicPrintConfig modifier_config;
+        modifier_config.set_deserialize_strict({ { "infill_every_layers", 2 } });
+        modifier->config.assign_config(modifier_config);
+        object->add_instance();
+        object->ensure_on_bed();
+
+        Slic3r::Print print;
+        print.apply(model, Slic3r::DynamicPrintConfig::full_print_config_with({
+            // Three layers fit below the nozzle diameter.
+            { "nozzle_diameter",        "0.7" },
+            { "layer_height",           0.2 },
+            { "first_layer_height",     0.2 },
+            { "infill_every_layers",    3 },
+            { "top_solid_layers",       0 },
+            { "bottom_solid_layers",    0 }
+        }));
+        print.process();
+        const PrintObject &print_object = *print.get_object(0);
+        REQUIRE(print_object.layers().size() == 100);
+        REQUIRE(print_object.num_printing_regions() == 2);
+        REQUIRE(print_object.printing_region(0).config().infill_every_layers.value + print_object.printing_region(1).config().infill_every_layers.value == 5);
+
+        THEN("infill of each group of layers of each region is combined into the uppermost layer of the group") {
+            for (size_t region_id = 0; region_id < print_object.num_printing_regions(); ++ region_id) {
+                const size_t every_n_layers = print_object.printing_region(region_id).config().infill_every_layers.value;
+                // The first layer is not combined, the layers above are combined in groups from the bottom,
+                // the last layer of the region combining two layers is left alone.
+                const size_t last_group_top = (print_object.layers().size() - 1) / every_n_layers * every_n_layers;
+                size_t       num_combined   = 0;
+                for (const Layer *layer : print_object.layers()) {
+                    INFO("Region " << region_id << ", layer " << layer->id());
+                    const LayerRegion *layerm       = layer->get_region(int(region_id));
+                    const bool         grouped      = layer->id() > 0 && layer->id() <= last_group_top;
+                    const bool         uppermost    = grouped && layer->id() % every_n_layers == 0;
+                    size_t             num_surfaces = 0;
+                    for (const Surface &surface : layerm->fill_surfaces())
+                        if (surface.thickness_layers > 1) {
+                            REQUIRE(surface.surface_type == stInternal);
+                            REQUIRE(surface.thickness_layers == every_n_layers);
+                            REQUIRE(surface.thickness == Approx(0.2 * every_n_layers));
+                            ++ num_surfaces;
+                        }
+                    REQUIRE((num_surfaces > 0) == uppermost);
+                    // The infill of the lower layers of a group is replaced by void.
+                    REQUIRE(layerm->fill_surfaces().has(stInternalVoid) == (grouped && ! uppermost));
+                    if (uppermost)
+                        ++ num_combined;
+                }
+                REQUIRE(num_combined == (every_n_layers == 3 ? 33 : 49));
+            }
+        }
+    }
+
     WHEN("infill_every_layers disabled") {
         // we disable combination after infill has been generated
         Slic3r::Print print;
@@ -455,6 +591,78 @@ SCENARIO("Combine infill", "[Fill]")
     }
 }
 
+// Extrusion roles and polylines of the fills of each region of a layer in their order and the ranges of the fills of the islands.
+struct LayerFills
+{
+    std::vector<std::vector<std::pair<ExtrusionRole, Polylines>>> regions;
+    std::vector<std::tuple<uint32_t, uint32_t, uint32_t>>          island_fills;
+
+    bool operator==(const LayerFills &rhs) const { return regions == rhs.regions && island_fills == rhs.island_fills; }
+};
+
+// Fills of a cube, the left half of which is overridden by a modifier with another infill pattern and density.
+static std::vector<LayerFills> fills_of_cube_with_modifier()
+{
+    Model        model;
+    ModelObject *object = model.add_object();
+    object->add_volume(Test::mesh(Test::TestMesh::cube_20x20x20));
+    ModelVolume *modifier = object->add_volume(Test::mesh(Test::TestMesh::cube_20x20x20), ModelVolumeType::PARAMETER_MODIFIER);
+    modifier->set_scaling_factor(Vec3d(0.5, 1., 1.));
+    DynamicPrintConfig modifier_config;
+    modifier_config.set_deserialize_strict({
+        { "fill_pattern",   "honeycomb" },
+        { "fill_density",   "40%" }
+    });
+    modifier->config.assign_config(modifier_config);
+    object->add_instance();
+    object->ensure_on_bed();
+
+    Print print;
+    print.apply(model, Slic3r::DynamicPrintConfig::full_print_config_with({
+        { "fill_pattern",           "gyroid" },
+        { "fill_density",           "20%" },
+        { "top_fill_pattern",       "monotonic" },
+        { "bottom_fill_pattern",    "concentric" },
+        { "top_solid_layers",       3 },
+        { "bottom_solid_layers",    3 }
+    }));
+    print.validate();
+    print.process();
+
+    std::vector<LayerFills> out;
+    for (const Layer *layer : print.get_object(0)->layers()) {
+        LayerFills &fills = out.emplace_back();
+        for (const LayerRegion *layerm : layer->regions()) {
+            std::vector<std::pair<ExtrusionRole, Polylines>> &region = fills.regions.emplace_back();
+            for (const ExtrusionEntity *fill : layerm->fills().entities)
+                region.emplace_back(fill->role(), fill->as_polylines());
+        }
+        for (const LayerSlice &lslice : layer->lslices_ex)
+            for (const LayerIsland &island : lslice.islands)
+                for (const LayerExtrusionRange &range : island.fills)
+                    fills.island_fills.emplace_back(range.region(), *range.begin(), *range.end());
+    }
+    return out;
+}
+
+TEST_CASE("Fills of a layer with multiple regions do not depend on the number of threads", "[Fill]") {
+    const std::vector<LayerFills> parallel = fills_of_cube_with_modifier();
+    // Both regions get sparse infill of a different pattern and top and bottom solid infill.
+    REQUIRE(std::any_of(parallel.begin(), parallel.end(), [](const LayerFills &fills) {
+        return fills.regions.size() == 2 && ! fills.regions.front().empty() && ! fills.regions.back().empty();
+    }));
+    std::vector<LayerFills> serial;
+    {
+        tbb::global_control parallelism(tbb::global_control::max_allowed_parallelism, 1);
+        serial = fills_of_cube_with_modifier();
+    }
+    REQUIRE(serial.size() == parallel.size());
+    for (size_t i = 0; i < serial.size(); ++ i) {
+        INFO("Layer " << i);
+        REQUIRE(serial[i] == parallel[i]);
+    }
+}
+
 SCENARIO("Infill density zero", "[Fill]")
 {
     WHEN("20mm cube is sliced") {
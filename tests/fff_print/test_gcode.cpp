@@ -8,8 +8,13 @@
 #include <memory>
 #include <regex>
 #include <fstream>
+#include <sstream>
+
+#include <boost/filesystem.hpp>
 
 #include "libslic3r/GCode.hpp"
+#include "libslic3r/GCode/GCodeProcessor.hpp"
+#include "libslic3r/GCodeReader.hpp"
 #include "libslic3r/Geometry/ConvexHull.hpp"
 #include "test_data.hpp"
 
@@ -166,7 +171,7 @@ TEST_CASE("Extrusion, travels, temperatures", "[GCode]") {
                 travel_moves.emplace_back(scaled(line.x()), scaled(line.y()));
             }
         } else if (line.cmd_is("M104") || line.cmd_is("M109")) {
-            const std::optional<double> parsed_temperature = parse_axis(line.raw(), "S");
+            const std::optional<double> parsed_temperature = parse_axis(std::string(line.raw()), "S");
             if (!parsed_temperature) {
                 FAIL("Failed to parse temperature!");
             }
@@ -235,7 +240,7 @@ void check_m73s(Print& print){
     parser.parse_buffer(gcode, [&] (Slic3r::GCodeReader &self, const Slic3r::GCodeReader::GCodeLine &line) {
 
         if (line.cmd_is("M73")) {
-            std::optional<double> p = parse_axis(line.raw(), "P");
+            std::optional<double> p = parse_axis(std::string(line.raw()), "P");
             if (!p) {
                 FAIL("Failed to parse percent");
             }
@@ -316,6 +321,208 @@ TEST_CASE("M73s have correct percent values", "[GCode]") {
 }
 
 
+TEST_CASE("Streaming G-code processing", "[GCode]") {
+    DynamicPrintConfig config = Slic3r::DynamicPrintConfig::full_print_config();
+    config.set_deserialize_strict({
+        { "gcode_flavor",    "marlin2" },
+        { "remaining_times", true },
+    });
+    Print print;
+    Model model;
+    Test::init_print({TestMesh::cube_20x20x20}, print, model, config);
+
+    auto m73s = [](const std::string &gcode) {
+        std::vector<std::string> out;
+        std::istringstream stream(gcode);
+        for (std::string line; std::getline(stream, line);)
+            if (line.rfind("M73", 0) == 0)
+                out.emplace_back(line);
+        return out;
+    };
+
+    const std::vector<std::string> expected   = m73s(Test::gcode(print));
+    const std::string              print_time = print.print_statistics().estimated_normal_print_time;
+    print.enable_gcode_streaming(true);
+    const std::vector<std::string> streamed   = m73s(Test::gcode(print));
+
+    CHECK(! expected.empty());
+    CHECK(streamed == expected);
+    CHECK(print.print_statistics().estimated_normal_print_time == print_time);
+}
+
+TEST_CASE("Streaming G-code processing retains a bounded number of moves", "[GCode]") {
+    DynamicPrintConfig config = Slic3r::DynamicPrintConfig::full_print_config();
+    config.set_deserialize_strict({
+        { "gcode_flavor",    "marlin2" },
+        { "layer_height",    0.1 },
+        { "remaining_times", true },
+    });
+    Print print;
+    Model model;
+    Test::init_print({TestMesh::cube_20x20x20}, print, model, config, false, 2);
+    const std::string gcode = Test::gcode(print);
+
+    GCodeProcessor processor;
+    processor.initialize_result_moves();
+    processor.apply_config(print.config());
+    processor.enable_streaming(true);
+
+    // Feed the G-code in buffers of a few lines, as GCodeGenerator does, and track the moves retained in between.
+    size_t g1_lines     = 0;
+    size_t peak_moves   = 0;
+    size_t buffer_begin = 0;
+    size_t buffer_lines = 0;
+    for (size_t line_begin = 0; line_begin < gcode.size();) {
+        size_t line_end = gcode.find('\n', line_begin);
+        line_end = line_end == std::string::npos ? gcode.size() : line_end + 1;
+        if (gcode.compare(line_begin, 3, "G1 ") == 0)
+            ++ g1_lines;
+        line_begin = line_end;
+        if (++ buffer_lines == 16 || line_begin == gcode.size()) {
+            processor.process_buffer(gcode.substr(buffer_begin, line_begin - buffer_begin));
+            peak_moves   = std::max(peak_moves, processor.get_result().moves.size());
+            buffer_begin = line_begin;
+            buffer_lines = 0;
+        }
+    }
+    processor.finalize(false);
+
+    // The time estimator keeps a few hundred moves in flight, the processed moves are released.
+    constexpr const size_t max_retained_moves = 2048;
+    REQUIRE(g1_lines > 10 * max_retained_moves);
+    CHECK(peak_moves < max_retained_moves);
+    CHECK(processor.get_result().moves.empty());
+}
+
+
+TEST_CASE("Single pass G-code export", "[GCode]") {
+    DynamicPrintConfig config = Slic3r::DynamicPrintConfig::full_print_config();
+    config.set_deserialize_strict({
+        { "gcode_flavor",    "marlin2" },
+        { "remaining_times", true },
+    });
+    Print print;
+    Model model;
+    Test::init_print({TestMesh::cube_20x20x20}, print, model, config);
+
+    // Split into lines without the trailing spaces the reserved lines are padded with.
+    auto lines = [](const std::string &gcode) {
+        std::vector<std::string> out;
+        std::istringstream stream(gcode);
+        for (std::string line; std::getline(stream, line);) {
+            line.erase(line.find_last_not_of(' ') + 1);
+            out.emplace_back(line);
+        }
+        return out;
+    };
+    // Drop the header with the time stamp, the M73 lines and the empty comments left in the reserved lines.
+    auto without_m73s = [](const std::vector<std::string> &lines) {
+        std::vector<std::string> out;
+        for (size_t i = 1; i < lines.size(); ++ i)
+            if (lines[i].rfind("M73", 0) != 0 && lines[i] != ";")
+                out.emplace_back(lines[i]);
+        return out;
+    };
+
+    const std::vector<std::string> expected = lines(Test::gcode(print));
+    print.enable_gcode_single_pass(true);
+    const std::vector<std::string> single_pass = lines(Test::gcode(print));
+
+    REQUIRE(! expected.empty());
+    // The estimated times and the filament statistics are filled in, the M73 lines are placed differently.
+    CHECK(without_m73s(single_pass) == without_m73s(expected));
+
+    std::vector<std::pair<int, int>> m73s;
+    for (const std::string &line : single_pass)
+        if (int percent, remaining; sscanf(line.c_str(), "M73 P%d R%d", &percent, &remaining) == 2)
+            m73s.emplace_back(percent, remaining);
+    REQUIRE(m73s.size() > 2);
+    CHECK(m73s.front().first == 0);
+    CHECK(m73s.front().second > 0);
+    CHECK(m73s.back() == std::make_pair(100, 0));
+    for (size_t i = 1; i < m73s.size(); ++ i) {
+        CHECK(m73s[i].first >= m73s[i - 1].first);
+        CHECK(m73s[i].second <= m73s[i - 1].second);
+    }
+}
+
+
+TEST_CASE("Parallel G-code parsing", "[GCode]") {
+    // Mixed line endings, empty lines, long lines and no newline at the end of file.
+    std::string gcode;
+    for (size_t i = 0; i < 50000; ++ i) {
+        gcode += "G1 X" + std::to_string(i % 200) + ".125 Y" + std::to_string(i % 170) + " E0.0123\r\n";
+        gcode += i % 3 == 0 ? "\n" : "M104 S215\r";
+        if (i % 100 == 0)
+            gcode += "; " + std::string(i % 1000, 'x') + "\n";
+    }
+    gcode += "G1 X5 Y5";
+
+    const std::string path = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string();
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << gcode;
+    }
+
+    std::vector<std::string>         serial_lines, parallel_lines;
+    std::vector<float>               serial_x, parallel_x;
+    std::vector<std::vector<size_t>> serial_ends, parallel_ends;
+    GCodeReader                      serial_reader, parallel_reader;
+    serial_reader.parse_file(path, [&](GCodeReader &reader, const GCodeReader::GCodeLine &line) {
+        serial_lines.emplace_back(line.raw());
+        serial_x.emplace_back(reader.x());
+    }, serial_ends);
+    parallel_reader.parse_file_parallel(path, [&](GCodeReader &reader, const GCodeReader::GCodeLine &line) {
+        parallel_lines.emplace_back(line.raw());
+        parallel_x.emplace_back(reader.x());
+    }, parallel_ends);
+    boost::filesystem::remove(path);
+
+    CHECK(serial_lines.size() > 100000);
+    CHECK(parallel_lines == serial_lines);
+    CHECK(parallel_x == serial_x);
+    CHECK(parallel_ends == serial_ends);
+}
+
+TEST_CASE("G-code file terminated by carriage returns only", "[GCode]") {
+    // Each line end is found without scanning the rest of the file, which would take quadratic time here.
+    std::string gcode;
+    for (size_t i = 0; i < 100000; ++ i)
+        gcode += "G1 X" + std::to_string(i) + "\r";
+
+    const std::string path = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string();
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << gcode;
+    }
+    std::vector<std::string> lines;
+    GCodeReader reader;
+    reader.parse_file_raw(path, [&lines](GCodeReader &, const char *begin, const char *end) { lines.emplace_back(begin, end); });
+    boost::filesystem::remove(path);
+
+    REQUIRE(lines.size() == 100000);
+    CHECK(lines.front() == "G1 X0");
+    CHECK(lines.back() == "G1 X99999");
+}
+
+TEST_CASE("G-code line modified by set() owns its raw text", "[GCode]") {
+    const std::string gcode = "G1 X1 Y2 E3\nG1 X4\n";
+    std::vector<GCodeReader::GCodeLine> lines;
+    GCodeReader reader;
+    reader.parse_buffer(gcode, [&lines](GCodeReader &reader, const GCodeReader::GCodeLine &line) {
+        GCodeReader::GCodeLine modified(line);
+        modified.set(reader, Z, 1.5f);
+        lines.emplace_back(std::move(modified));
+    });
+
+    REQUIRE(lines.size() == 2);
+    CHECK(lines.front().raw() == "G1 Z1.500 X1 Y2 E3");
+    CHECK(lines.back().raw() == "G1 Z1.500 X4");
+    CHECK(lines.back().cmd_is("G1"));
+    CHECK(gcode == "G1 X1 Y2 E3\nG1 X4\n");
+}
+
+
 TEST_CASE("M201 for acceleation reset", "[GCode]") {
     DynamicPrintConfig config = Slic3r::DynamicPrintConfig::full_print_config();
     config.set_deserialize_strict({
@@ -0,0 +1,125 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iterator>
+#include <stdexcept>
+#include <thread>
+
+#include <boost/filesystem.hpp>
+#include <boost/nowide/cstdio.hpp>
+#include <boost/nowide/fstream.hpp>
+
+#include <libslic3r/Exception.hpp>
+#include <libslic3r/GCode/BinarizerWorker.hpp>
+#include <libslic3r/GCode/GCodeProcessor.hpp>
+
+#include "test_data.hpp"
+
+using namespace Slic3r;
+
+// Chunks of about 8kB split at the line ends. GCodeProcessor::post_process() pushes larger chunks, the smaller ones
+// make the short G-code of the test fill the queue of BinarizerWorker.
+static std::vector<std::string> gcode_chunks(const std::string &gcode)
+{
+    std::vector<std::string> out;
+    for (size_t begin = 0; begin < gcode.size();) {
+        size_t end = gcode.find('\n', std::min(begin + 8192, gcode.size() - 1));
+        end = end == std::string::npos ? gcode.size() : end + 1;
+        out.emplace_back(gcode.substr(begin, end - begin));
+        begin = end;
+    }
+    return out;
+}
+
+// Binarizes the chunks either synchronously or by BinarizerWorker, returns the content of the binary G-code file.
+static std::string binarize(const std::vector<std::string> &chunks, bool use_worker)
+{
+    const std::string path = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string();
+    FILE *file = boost::nowide::fopen(path.c_str(), "wb");
+    REQUIRE(file != nullptr);
+
+    bgcode::binarize::Binarizer binarizer;
+    binarizer.set_enabled(true);
+    bgcode::binarize::BinaryData &binary_data = binarizer.get_binary_data();
+    binary_data.printer_metadata.raw_data.emplace_back("printer_model", "MK4");
+    binary_data.print_metadata.raw_data.emplace_back("estimated printing time (normal mode)", "1h");
+    binary_data.slicer_metadata.raw_data.emplace_back("layer_height", "0.2");
+    REQUIRE(binarizer.initialize(*file, GCodeProcessor::get_binarizer_config()) == bgcode::core::EResult::Success);
+    if (use_worker) {
+        BinarizerWorker worker(binarizer);
+        for (const std::string &chunk : chunks)
+            worker.push(std::string(chunk));
+        worker.finish();
+    } else {
+        for (const std::string &chunk : chunks)
+            REQUIRE(binarizer.append_gcode(chunk) == bgcode::core::EResult::Success);
+    }
+    REQUIRE(binarizer.finalize() == bgcode::core::EResult::Success);
+    fclose(file);
+
+    std::string out;
+    {
+        boost::nowide::ifstream in(path, std::ios::binary);
+        out.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    boost::filesystem::remove(path);
+    return out;
+}
+
+TEST_CASE("Binary G-code appended by BinarizerWorker", "[GCode][Binarizer]") {
+    Print print;
+    Model model;
+    Test::init_print({ Test::TestMesh::cube_20x20x20 }, print, model, DynamicPrintConfig::full_print_config());
+    const std::vector<std::string> chunks = gcode_chunks(Test::gcode(print));
+    // More chunks than BinarizerWorker queues, so that the producer waits for the worker.
+    REQUIRE(chunks.size() > 16);
+
+    SECTION("is identical to the binary G-code appended synchronously") {
+        const std::string expected = binarize(chunks, false);
+        REQUIRE(! expected.empty());
+        REQUIRE(binarize(chunks, true) == expected);
+    }
+
+    SECTION("reports an error of the binarizer") {
+        std::atomic<size_t> appended { 0 };
+        BinarizerWorker worker([&appended](const std::string &) { return ++ appended < 3; });
+        auto append_all = [&worker, &chunks]() {
+            for (const std::string &chunk : chunks)
+                worker.push(std::string(chunk));
+            worker.finish();
+        };
+        REQUIRE_THROWS_AS(append_all(), Slic3r::RuntimeError);
+        // Nothing is appended after the failure.
+        REQUIRE(appended == 3);
+    }
+
+    SECTION("reports an exception thrown by the binarizer") {
+        BinarizerWorker worker([](const std::string &) -> bool { throw std::runtime_error("binarizer failed"); });
+        auto append_all = [&worker, &chunks]() {
+            for (const std::string &chunk : chunks)
+                worker.push(std::string(chunk));
+            worker.finish();
+        };
+        REQUIRE_THROWS_AS(append_all(), Slic3r::RuntimeError);
+    }
+
+    SECTION("drops the G-code not appended yet if canceled") {
+        std::atomic<size_t> appended { 0 };
+        {
+            BinarizerWorker worker([&appended](const std::string &) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                ++ appended;
+                return true;
+            });
+            for (const std::string &chunk : chunks)
+                worker.push(std::string(chunk));
+            // The export was canceled, the worker is destroyed without finish().
+        }
+        const size_t appended_when_canceled = appended;
+        REQUIRE(appended_when_canceled < chunks.size());
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        REQUIRE(appended == appended_when_canceled);
+    }
+}
@@ -0,0 +1,141 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/nowide/fstream.hpp>
+
+#include <libslic3r/GCode/CompactMoves.hpp>
+
+#include "test_data.hpp"
+
+using namespace Slic3r;
+using namespace Catch;
+
+using MoveVertex = GCodeProcessorResult::MoveVertex;
+
+static std::vector<MoveVertex> make_moves(size_t count)
+{
+    std::vector<MoveVertex> moves(1);
+    for (size_t i = 1; i < count; ++ i) {
+        MoveVertex &move     = moves.emplace_back();
+        move.gcode_id        = unsigned(3 * i);
+        move.type            = i % 10 == 0 ? EMoveType::Travel : EMoveType::Extrude;
+        move.extrusion_role  = i % 10 == 0 ? GCodeExtrusionRole::None : GCodeExtrusionRole::Perimeter;
+        move.layer_id        = unsigned(i / 100);
+        move.position        = Vec3f(float(i % 37) * 1.234f, 200.f - float(i % 53) * 0.567f, 0.2f * float(1 + i / 100));
+        move.delta_extruder  = float(i % 7) * 0.01f;
+        move.feedrate        = float(20 + 10 * ((i / 50) % 3));
+        move.actual_feedrate = move.feedrate;
+        move.width           = 0.45f;
+        move.height          = 0.2f;
+        move.mm3_per_mm      = 0.08f;
+        move.fan_speed       = i < 200 ? 0.f : 100.f;
+        move.temperature     = 215.f;
+        move.time            = { 0.01f * float(i), 0.02f * float(i) };
+    }
+    return moves;
+}
+
+static void check_equal(const MoveVertex &decoded, const MoveVertex &move)
+{
+    REQUIRE(decoded.gcode_id == move.gcode_id);
+    REQUIRE(decoded.type == move.type);
+    REQUIRE(decoded.extrusion_role == move.extrusion_role);
+    REQUIRE(decoded.layer_id == move.layer_id);
+    REQUIRE(decoded.position.x() == Approx(move.position.x()).margin(0.001));
+    REQUIRE(decoded.position.y() == Approx(move.position.y()).margin(0.001));
+    REQUIRE(decoded.position.z() == Approx(move.position.z()).margin(0.001));
+    REQUIRE(decoded.delta_extruder == move.delta_extruder);
+    REQUIRE(decoded.feedrate == move.feedrate);
+    REQUIRE(decoded.width == move.width);
+    REQUIRE(decoded.fan_speed == move.fan_speed);
+    REQUIRE(decoded.time == move.time);
+}
+
+TEST_CASE("Compact moves round trip", "[GCode][CompactMoves]") {
+    const std::vector<MoveVertex> moves = make_moves(1000);
+    const CompactMoveVertices     compact(moves, CompactMoveVertices::all_fields());
+    REQUIRE(compact.size() == moves.size());
+
+    SECTION("sequential access") {
+        size_t idx = 0;
+        for (const MoveVertex &move : compact)
+            check_equal(move, moves[idx ++]);
+        REQUIRE(idx == moves.size());
+    }
+    SECTION("random access") {
+        for (size_t idx : { size_t(0), size_t(1), size_t(63), size_t(64), size_t(65), size_t(500), moves.size() - 1 })
+            check_equal(compact[idx], moves[idx]);
+    }
+    SECTION("memory usage") {
+        CHECK(compact.memory_usage() * 3 < moves.size() * sizeof(MoveVertex));
+    }
+}
+
+TEST_CASE("Compact moves without optional fields", "[GCode][CompactMoves]") {
+    const std::vector<MoveVertex> moves = make_moves(200);
+    const CompactMoveVertices     compact(moves, CompactMoveVertices::Field::Feedrate);
+    const MoveVertex              move = compact[150];
+    CHECK(move.feedrate == moves[150].feedrate);
+    CHECK(move.width == 0.f);
+    CHECK(move.delta_extruder == 0.f);
+    CHECK(move.time[0] == 0.f);
+}
+
+TEST_CASE("Compact moves G-code line ids update", "[GCode][CompactMoves]") {
+    std::vector<MoveVertex> moves = make_moves(1000);
+    CompactMoveVertices     compact(moves, CompactMoveVertices::all_fields());
+    // Lines inserted in front of every 10th G-code line, as post-processing does.
+    auto update = [](unsigned int gcode_id) { return gcode_id + gcode_id / 10; };
+    compact.update_gcode_ids(update);
+    for (MoveVertex &move : moves)
+        move.gcode_id = update(move.gcode_id);
+    size_t idx = 0;
+    for (const MoveVertex &move : compact)
+        check_equal(move, moves[idx ++]);
+    check_equal(compact[777], moves[777]);
+
+    // Moves appended after the update are delta encoded against the updated ids.
+    MoveVertex move = moves.back();
+    move.gcode_id += 5;
+    compact.push_back(move);
+    check_equal(compact[compact.size() - 1], move);
+}
+
+TEST_CASE("Compact moves are filled while processing G-code", "[GCode][CompactMoves]") {
+    DynamicPrintConfig config = Slic3r::DynamicPrintConfig::full_print_config();
+    Print print;
+    Model model;
+    Test::init_print({ Test::TestMesh::cube_20x20x20 }, print, model, config);
+    const std::string path = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string();
+    {
+        boost::nowide::ofstream file(path, std::ios::binary);
+        file << Test::gcode(print);
+    }
+
+    GCodeProcessor processor;
+    processor.process_file(path);
+    const GCodeProcessorResult &expected = processor.get_result();
+    REQUIRE(expected.compact_moves == nullptr);
+
+    GCodeProcessor compact_processor;
+    compact_processor.enable_compact_moves(true);
+    compact_processor.process_file(path);
+    const GCodeProcessorResult &result = compact_processor.get_result();
+    boost::filesystem::remove(path);
+
+    REQUIRE(result.moves.empty());
+    REQUIRE(result.compact_moves != nullptr);
+    REQUIRE(result.compact_moves->size() == expected.moves.size());
+    // Many more moves than the time estimator keeps in flight.
+    REQUIRE(expected.moves.size() > 10000);
+    size_t idx = 0;
+    for (const MoveVertex &move : *result.compact_moves) {
+        const MoveVertex &expected_move = expected.moves[idx ++];
+        check_equal(move, expected_move);
+        REQUIRE(move.actual_feedrate == expected_move.actual_feedrate);
+        REQUIRE(move.height == expected_move.height);
+        REQUIRE(move.internal_only == expected_move.internal_only);
+    }
+    CHECK(result.print_statistics.modes.front().time == expected.print_statistics.modes.front().time);
+}
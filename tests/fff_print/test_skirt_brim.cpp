@@ -2,10 +2,12 @@
 #include <catch2/catch_approx.hpp>
 
 #include "libslic3r/GCodeReader.hpp"
+#include "libslic3r/ClipperUtils.hpp"
 #include "libslic3r/Config.hpp"
 #include "libslic3r/Geometry.hpp"
 
 #include <boost/algorithm/string.hpp>
+#include <oneapi/tbb/global_control.h>
 
 #include "test_data.hpp" // get access to init_print, etc
 
@@ -268,3 +270,53 @@ SCENARIO("Original Slic3r Skirt/Brim tests", "[SkirtBrim]") {
         }
     }
 }
+
+// The brim loops of many objects are offset by expand_parallel(), which splits them into clusters and tiles.
+static void brim_of_many_objects(const DynamicPrintConfig &config, Print &print, Model &model)
+{
+    Slic3r::Test::init_print({ Slic3r::Test::mesh(TestMesh::cube_20x20x20, Vec3d::Zero(), 0.1) }, print, model, config, false, 80);
+    print.process();
+}
+
+TEST_CASE("Brim of many objects", "[SkirtBrim]") {
+    auto config = Slic3r::DynamicPrintConfig::full_print_config_with({
+        { "skirts",         0 },
+        { "brim_width",     5 },
+        { "perimeters",     1 },
+        { "fill_density",   "0%" }
+    });
+    Print print;
+    Model model;
+    brim_of_many_objects(config, print, model);
+    const Polylines brim = print.brim().as_polylines();
+    REQUIRE(! brim.empty());
+
+    SECTION("does not depend on the number of threads") {
+        tbb::global_control single_thread(tbb::global_control::max_allowed_parallelism, 1);
+        Print serial_print;
+        Model serial_model;
+        brim_of_many_objects(config, serial_print, serial_model);
+        REQUIRE(serial_print.brim().as_polylines() == brim);
+    }
+    SECTION("islands grown in parallel match the serial expand followed by union") {
+        Polygons islands;
+        for (const PrintObject *object : print.objects())
+            for (const PrintInstance &instance : object->instances())
+                for (const ExPolygon &expolygon : object->layers().front()->lslices) {
+                    islands.emplace_back(expolygon.contour);
+                    islands.back().translate(instance.shift);
+                }
+        REQUIRE(islands.size() == 80);
+        const float spacing          = float(print.brim_flow().scaled_spacing());
+        Polygons    serial_islands   = islands;
+        Polygons    parallel_islands = islands;
+        for (int i = 0; i < 10; ++ i) {
+            serial_islands   = union_(expand(serial_islands, spacing, ClipperLib::jtSquare));
+            parallel_islands = expand_parallel(parallel_islands, spacing, ClipperLib::jtSquare);
+            REQUIRE(parallel_islands.size() == serial_islands.size());
+            REQUIRE(area(parallel_islands) == Approx(area(serial_islands)));
+            // The grown islands do not overlap.
+            REQUIRE(area(union_(parallel_islands)) == Approx(area(parallel_islands)));
+        }
+    }
+}
@@ -2,6 +2,7 @@
 
 #include "libslic3r/TriangleMesh.hpp"
 #include "libslic3r/TriangleMeshSlicer.hpp"
+#include "libslic3r/SliceCache.hpp"
 #include "libslic3r/Point.hpp"
 #include "libslic3r/Config.hpp"
 #include "libslic3r/Model.hpp"
@@ -177,6 +178,91 @@ SCENARIO( "TriangleMesh: slice behavior.") {
     }
 }
 
+TEST_CASE("Slicing with a MeshSlicingIndex matches slicing plane by plane", "[TriangleMeshSlicer]") {
+    const indexed_triangle_set sphere = its_make_sphere(10., PI / 36.);
+    MeshSlicingParams params;
+    params.trafo = Geometry::assemble_transform(Vec3d(1., 2., 10.), Vec3d(0.3, 0.2, 0.1));
+    const MeshSlicingIndex index(sphere, params.trafo);
+    REQUIRE(index.num_facets() > 0);
+
+    std::vector<float> zs;
+    for (float z = 0.05f; z < 20.f; z += 0.2f)
+        zs.emplace_back(z);
+    const std::vector<Polygons> layers = slice_mesh(index, zs, params);
+    REQUIRE(layers.size() == zs.size());
+    for (size_t i = 0; i < zs.size(); ++ i) {
+        const Polygons expected = slice_mesh(sphere, zs[i], params);
+        REQUIRE(layers[i].size() == expected.size());
+        double area = 0., area_expected = 0.;
+        for (const Polygon &poly : layers[i])
+            area += poly.area();
+        for (const Polygon &poly : expected)
+            area_expected += poly.area();
+        REQUIRE(std::abs(area - area_expected) <= 1e-9 * std::abs(area_expected) + 1.);
+    }
+}
+
+TEST_CASE("Slicing with a MeshSlicingIndex at vertex heights matches slice_facet()", "[TriangleMeshSlicer]") {
+    auto test = [](const indexed_triangle_set &mesh, const Transform3d &trafo, std::vector<float> zs) {
+        const MeshSlicingIndex index(mesh, trafo);
+        REQUIRE(index.num_facets() > 0);
+        std::sort(zs.begin(), zs.end());
+        zs.erase(std::unique(zs.begin(), zs.end()), zs.end());
+        const std::vector<std::vector<MeshSlicingLine>> batched  = slice_mesh_lines(index, zs, true);
+        const std::vector<std::vector<MeshSlicingLine>> expected = slice_mesh_lines(index, zs, false);
+        REQUIRE(batched.size() == zs.size());
+        REQUIRE(expected.size() == zs.size());
+        for (size_t i = 0; i < zs.size(); ++ i) {
+            INFO("z = " << zs[i]);
+            REQUIRE(batched[i] == expected[i]);
+        }
+    };
+
+    SECTION("Cube sliced at its vertex heights and in between") {
+        const indexed_triangle_set cube = its_make_cube(20., 20., 20.);
+        test(cube, Transform3d::Identity(), { 0.f, 5.f, 10.f, 20.f });
+    }
+
+    SECTION("Sphere sliced at all its vertex heights") {
+        const indexed_triangle_set sphere = its_make_sphere(10., PI / 18.);
+        const Transform3d          trafo  = Geometry::assemble_transform(Vec3d(0., 0., 10.));
+        std::vector<float> zs;
+        for (const Vec3f &v : MeshSlicingIndex(sphere, trafo).vertices())
+            zs.emplace_back(v.z());
+        test(sphere, trafo, zs);
+    }
+}
+
+TEST_CASE("SliceCache shares slices of meshes with identical content", "[TriangleMeshSlicer]") {
+    auto mesh1 = std::make_shared<const TriangleMesh>(make_cube(20., 20., 20.));
+    auto mesh2 = std::make_shared<const TriangleMesh>(make_cube(20., 20., 20.));
+    auto mesh3 = std::make_shared<const TriangleMesh>(make_cube(20., 20., 10.));
+    const std::vector<float> zs { 0.1f, 5.f, 9.9f };
+    MeshSlicingParamsEx params;
+    const std::vector<ExPolygons> slices = slice_mesh_ex(mesh1->its, zs, params);
+
+    SliceCache cache;
+    cache.insert(mesh1, zs, params, slices);
+    REQUIRE(cache.size() == 1);
+    std::optional<std::vector<ExPolygons>> cached = cache.find(mesh2, zs, params);
+    REQUIRE(cached.has_value());
+    REQUIRE(*cached == slices);
+    REQUIRE(! cache.find(mesh3, zs, params).has_value());
+    REQUIRE(! cache.find(mesh1, { 0.1f, 5.f }, params).has_value());
+    MeshSlicingParamsEx params_offset = params;
+    params_offset.extra_offset = 0.1f;
+    REQUIRE(! cache.find(mesh1, zs, params_offset).has_value());
+
+    // The slices are retained as long as any of the meshes sliced into them is alive.
+    mesh1.reset();
+    cache.purge_released();
+    REQUIRE(cache.find(mesh2, zs, params).has_value());
+    mesh2.reset();
+    cache.purge_released();
+    REQUIRE(cache.size() == 0);
+    REQUIRE(cache.memory_usage() == 0);
+}
+
 SCENARIO( "make_xxx functions produce meshes.") {
     GIVEN("make_cube() function") {
         WHEN("make_cube() is called with arguments 20,20,20") {
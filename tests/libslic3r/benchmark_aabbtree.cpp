@@ -0,0 +1,85 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark_all.hpp>
+#include <test_utils.hpp>
+
+#include <libslic3r/AABBTreeIndirect.hpp>
+#include <libslic3r/AABBTreeWide.hpp>
+
+using namespace Slic3r;
+
+struct RayQueries
+{
+    std::vector<Vec3d> origins;
+    std::vector<Vec3d> dirs;
+    std::vector<Vec3d> points;
+};
+
+// Rays from random points inside the bounding box of the mesh and from outside of the mesh towards it,
+// closest point queries from random points around the mesh.
+static RayQueries random_queries(const indexed_triangle_set &its, size_t num_queries)
+{
+    const BoundingBoxf3 bbox   = bounding_box(its);
+    const Vec3d         center = bbox.center();
+    const double        radius = bbox.size().norm();
+    std::mt19937                           rng(0);
+    std::uniform_real_distribution<double> dist(-1., 1.);
+    RayQueries                             out;
+    for (size_t i = 0; i < num_queries; ++ i) {
+        const Vec3d point = center + 0.5 * Vec3d(dist(rng) * bbox.size().x(), dist(rng) * bbox.size().y(), dist(rng) * bbox.size().z());
+        const Vec3d dir   = Vec3d(dist(rng), dist(rng), dist(rng)).normalized();
+        if (i % 2 == 0) {
+            out.origins.emplace_back(point);
+            out.dirs.emplace_back(dir);
+        } else {
+            out.origins.emplace_back(center - radius * dir);
+            out.dirs.emplace_back((point - out.origins.back()).normalized());
+        }
+        out.points.emplace_back(center + 0.6 * radius * Vec3d(dist(rng), dist(rng), dist(rng)));
+    }
+    return out;
+}
+
+template<typename TreeType>
+static void benchmark_tree(const char *tree_name, const indexed_triangle_set &its, const RayQueries &queries)
+{
+    BENCHMARK(std::string("Build ") + tree_name) {
+        return AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set<TreeType>(its.vertices, its.indices);
+    };
+
+    const auto tree = AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set<TreeType>(its.vertices, its.indices);
+    BENCHMARK(std::string("Cast rays, ") + tree_name) {
+        size_t num_hits = 0;
+        for (size_t i = 0; i < queries.origins.size(); ++ i) {
+            igl::Hit hit;
+            num_hits += AABBTreeIndirect::intersect_ray_first_hit(its.vertices, its.indices, tree, queries.origins[i], queries.dirs[i], hit);
+        }
+        return num_hits;
+    };
+
+    BENCHMARK(std::string("Closest points, ") + tree_name) {
+        double sum = 0;
+        for (const Vec3d &point : queries.points) {
+            size_t idx;
+            Vec3d  closest;
+            sum += AABBTreeIndirect::squared_distance_to_indexed_triangle_set(its.vertices, its.indices, tree, point, idx, closest);
+        }
+        return sum;
+    };
+}
+
+TEST_CASE("AABB tree benchmarks", "[AABBIndirect][.Benchmarks]") {
+    std::vector<std::pair<std::string, indexed_triangle_set>> meshes;
+    for (const char *name : { "frog_legs.obj", "extruder_idler.obj", "ipadstand.obj", "bridge.obj" })
+        meshes.emplace_back(name, load_model(name).its);
+    // High polygon count mesh.
+    meshes.emplace_back("sphere", its_make_sphere(25., PI / 720.));
+
+    for (const auto &[name, its] : meshes) {
+        const RayQueries queries = random_queries(its, 20000);
+        SECTION(name) {
+            benchmark_tree<AABBTreeIndirect::Tree3f>("balanced binary tree", its, queries);
+            benchmark_tree<AABBTreeIndirect::WideTree4f>("SAH tree with 4 wide nodes", its, queries);
+            benchmark_tree<AABBTreeIndirect::WideTree8f>("SAH tree with 8 wide nodes", its, queries);
+        }
+    }
+}
@@ -1,10 +1,13 @@
 #include <algorithm>
+#include <limits>
+#include <random>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_approx.hpp>
 #include <test_utils.hpp>
 
 #include <libslic3r/TriangleMesh.hpp>
 #include <libslic3r/AABBTreeIndirect.hpp>
+#include <libslic3r/AABBTreeWide.hpp>
 #include <libslic3r/AABBTreeLines.hpp>
 
 using namespace Slic3r;
@@ -63,6 +66,71 @@ TEST_CASE("Building a tree over a box, ray caster and closest query", "[AABBIndi
     REQUIRE(closest_point.z() == Approx(1.));
 }
 
+TEST_CASE("Wide AABB tree returns the same hits and distances as the balanced tree", "[AABBIndirect]")
+{
+    // Large enough to build the subtrees in parallel.
+    indexed_triangle_set its = its_make_sphere(10., PI / 60.);
+    its_merge(its, load_model("frog_legs.obj").its);
+    // Multiple copies of the same triangle with the same centroids.
+    for (int i = 0; i < 10; ++ i)
+        its_merge(its, indexed_triangle_set{ { { 0, 1, 2 } }, { Vec3f(-1.f, -1.f, 0.f), Vec3f(1.f, -1.f, 0.f), Vec3f(0.f, 1.f, 0.f) } });
+    auto tree = AABBTreeIndirect::build_aabb_tree_over_indexed_triangle_set(its.vertices, its.indices);
+    auto wide_tree4 = AABBTreeIndirect::build_wide_aabb_tree_over_indexed_triangle_set<4>(its.vertices, its.indices);
+    auto wide_tree8 = AABBTreeIndirect::build_wide_aabb_tree_over_indexed_triangle_set<8>(its.vertices, its.indices);
+    REQUIRE(! wide_tree4.empty());
+    REQUIRE(wide_tree4.entities().size() == its.indices.size());
+    REQUIRE(wide_tree8.entities().size() == its.indices.size());
+
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<double> dist(-1., 1.);
+    std::vector<Vec3d> origins;
+    std::vector<Vec3d> dirs;
+    for (size_t i = 0; i < 2000; ++ i) {
+        origins.emplace_back(Vec3d(dist(rng), dist(rng), dist(rng)) * 30.);
+        dirs.emplace_back(Vec3d(dist(rng), dist(rng), dist(rng)).normalized());
+    }
+
+    auto check = [&](const auto &wide_tree) {
+        size_t num_hits = 0;
+        for (size_t i = 0; i < origins.size(); ++ i) {
+            igl::Hit hit, wide_hit;
+            bool intersected = AABBTreeIndirect::intersect_ray_first_hit(its.vertices, its.indices, tree, origins[i], dirs[i], hit);
+            REQUIRE(AABBTreeIndirect::intersect_ray_first_hit(its.vertices, its.indices, wide_tree, origins[i], dirs[i], wide_hit) == intersected);
+            std::vector<igl::Hit> hits;
+            AABBTreeIndirect::intersect_ray_all_hits(its.vertices, its.indices, wide_tree, origins[i], dirs[i], hits);
+            REQUIRE(std::is_sorted(hits.begin(), hits.end(), [](const auto &l, const auto &r) { return l.t < r.t; }));
+            if (intersected) {
+                ++ num_hits;
+                REQUIRE(wide_hit.t == hit.t);
+                // On ties the balanced tree may report any of the triangles hit at the same distance,
+                // the wide tree reports the one with the lowest index.
+                int lowest_id = std::numeric_limits<int>::max();
+                for (const igl::Hit &h : hits)
+                    if (h.t == hit.t)
+                        lowest_id = std::min(lowest_id, h.id);
+                REQUIRE(wide_hit.id == lowest_id);
+                REQUIRE(std::find_if(hits.begin(), hits.end(), [&hit](const igl::Hit &h) { return h.t == hit.t && h.id == hit.id; }) != hits.end());
+            }
+
+            size_t idx, wide_idx;
+            Vec3d  point, wide_point;
+            double sqr_dist      = AABBTreeIndirect::squared_distance_to_indexed_triangle_set(its.vertices, its.indices, tree, origins[i], idx, point);
+            double wide_sqr_dist = AABBTreeIndirect::squared_distance_to_indexed_triangle_set(its.vertices, its.indices, wide_tree, origins[i], wide_idx, wide_point);
+            REQUIRE(wide_sqr_dist == Approx(sqr_dist));
+            REQUIRE((wide_point - origins[i]).squaredNorm() == Approx(wide_sqr_dist));
+
+            std::vector<size_t> in_radius      = AABBTreeIndirect::all_triangles_in_radius(its.vertices, its.indices, tree, origins[i], 25.);
+            std::vector<size_t> wide_in_radius = AABBTreeIndirect::all_triangles_in_radius(its.vertices, its.indices, wide_tree, origins[i], 25.);
+            std::sort(in_radius.begin(), in_radius.end());
+            std::sort(wide_in_radius.begin(), wide_in_radius.end());
+            REQUIRE(wide_in_radius == in_radius);
+        }
+        REQUIRE(num_hits > 0);
+    };
+    check(wide_tree4);
+    check(wide_tree8);
+}
+
 TEST_CASE("Creating a several 2d lines, testing closest point query", "[AABBIndirect]")
 {
     std::vector<Linef> lines { };
@@ -384,3 +384,147 @@ TEST_CASE("Traversing Clipper PolyTree", "[ClipperUtils]") {
         REQUIRE(count_polys(output) == reference.size());
     }
 }
+
+TEST_CASE("Clipper engines retained by a thread are reused", "[ClipperUtils]") {
+    const Polygon   square{ { 0, 0 }, { 100, 0 }, { 100, 100 }, { 0, 100 } };
+    const Polygon   square2{ { 50, 50 }, { 150, 50 }, { 150, 150 }, { 50, 150 } };
+    const Polygons  subject{ square };
+    const Polygons  clip{ square2 };
+    const Polygons  diff_reference  = diff(subject, clip);
+    const ExPolygons union_reference = union_ex(Polygons{ square, square2 });
+
+    SECTION("Repeated operations produce the same results") {
+        for (size_t i = 0; i < 10; ++ i) {
+            REQUIRE(diff(subject, clip) == diff_reference);
+            REQUIRE(union_ex(Polygons{ square, square2 }) == union_reference);
+            // Options of the engine are reset when borrowed.
+            ClipperUtils::ClipperEngine engine;
+            engine->ReverseSolution(true);
+        }
+        REQUIRE(diff(subject, clip) == diff_reference);
+    }
+
+    SECTION("Nested use of an engine") {
+        ClipperUtils::ClipperEngine engine;
+        engine->AddPaths(ClipperUtils::PolygonsProvider(subject), ClipperLib::ptSubject, true);
+        // Executed by a temporary engine, the engine of this thread is borrowed already.
+        REQUIRE(diff(subject, clip) == diff_reference);
+        engine->AddPaths(ClipperUtils::PolygonsProvider(clip), ClipperLib::ptClip, true);
+        ClipperLib::Paths out;
+        engine->Execute(ClipperLib::ctDifference, out, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+        REQUIRE(to_polygons(std::move(out)) == diff_reference);
+    }
+
+    SECTION("Results are appended to an existing container") {
+        Polygons polygons{ square };
+        append_diff(polygons, subject, clip);
+        REQUIRE(polygons.size() == diff_reference.size() + 1);
+        REQUIRE(polygons.front() == square);
+        REQUIRE(std::equal(diff_reference.begin(), diff_reference.end(), polygons.begin() + 1));
+
+        ExPolygons expolygons;
+        append_union_ex(expolygons, Polygons{ square, square2 });
+        append_union_ex(expolygons, Polygons{ square, square2 });
+        REQUIRE(expolygons.size() == 2 * union_reference.size());
+        REQUIRE(expolygons.front() == union_reference.front());
+        REQUIRE(expolygons.back() == union_reference.back());
+    }
+
+    SECTION("Repeated offsets produce the same results") {
+        const Polygons expand_reference = expand(subject, 10.f);
+        const Polygons shrink_reference = shrink(subject, 10.f);
+        for (size_t i = 0; i < 10; ++ i) {
+            REQUIRE(expand(subject, 10.f) == expand_reference);
+            REQUIRE(shrink(subject, 10.f) == shrink_reference);
+        }
+        // The Clipper engine cleaning up the offsets keeps its memory.
+        ClipperUtils::ClipperOffsetEngine engine;
+        REQUIRE(engine->MemoryRetained() > 0);
+    }
+}
+
+TEST_CASE("Parallel boolean operations match the serial ones", "[ClipperUtils]") {
+    const Polygon square{ { 0, 0 }, { 1000000, 0 }, { 1000000, 1000000 }, { 0, 1000000 } };
+    Polygons      subject;
+    // Grid of disjoint squares and of chains of overlapping squares.
+    for (int i = 0; i < 30; ++ i)
+        for (int j = 0; j < 30; ++ j) {
+            subject.emplace_back(square);
+            subject.back().translate(i * (i % 3 == 0 ? 900000 : 1100000), j * 1500000 + (i % 2) * 300000);
+        }
+    // A single large cluster of overlapping squares, which is united tile by tile.
+    for (int i = 0; i < 400; ++ i) {
+        subject.emplace_back(square);
+        subject.back().translate(100000000 + (i % 20) * 700000, (i / 20) * 700000);
+    }
+    Polygons clip;
+    for (int i = 0; i < 100; ++ i) {
+        clip.emplace_back(square);
+        clip.back().scale(0.3);
+        clip.back().translate(i * 1000000 + 100000, (i % 7) * 3000000 + 100000);
+    }
+
+    SECTION("union") {
+        Polygons reference = union_(subject);
+        Polygons result    = union_parallel(subject);
+        REQUIRE(result.size() == reference.size());
+        REQUIRE(area(result) == Approx(area(reference)));
+    }
+    SECTION("expand") {
+        Polygons reference = expand(subject, 150000.f, ClipperLib::jtSquare);
+        Polygons result    = expand_parallel(subject, 150000.f, ClipperLib::jtSquare);
+        REQUIRE(result.size() == reference.size());
+        REQUIRE(area(result) == Approx(area(reference)));
+    }
+    SECTION("diff_ex") {
+        const ExPolygons subject_ex = union_ex(subject);
+        const ExPolygons clip_ex    = union_ex(clip);
+        ExPolygons reference = diff_ex(subject_ex, clip_ex);
+        ExPolygons result    = diff_ex_parallel(subject_ex, clip_ex);
+        REQUIRE(result.size() == reference.size());
+        REQUIRE(area(result) == Approx(area(reference)));
+    }
+}
+
+TEST_CASE("Parallel expand of acute corners matches the serial expand followed by union", "[ClipperUtils]") {
+    const float  delta  = 1000000.f;
+    const double length = 5000000.;
+    // Wedge of the given half angle, with its tip at the origin pointing in the direction of the given angle.
+    auto wedge = [length](double half_angle, double angle, const Point &tip) {
+        const coord_t h = coord_t(length * std::tan(half_angle));
+        Polygon out{ { 0, 0 }, { - coord_t(length), h }, { - coord_t(length), - h } };
+        out.rotate(angle);
+        out.translate(tip);
+        return out;
+    };
+    // Pairs of wedges, whose tips are closer than their offset reaches, but further apart than twice the offset distance.
+    // The pairs are far from each other, each pair is expected to merge into a single polygon without holes.
+    auto pairs = [&wedge](double half_angle, double angle, coord_t gap) {
+        Polygons out;
+        for (int i = 0; i < 8; ++ i)
+            for (int j = 0; j < 5; ++ j) {
+                const Point tip(i * 30000000, j * 30000000);
+                out.emplace_back(wedge(half_angle, angle, tip));
+                out.emplace_back(wedge(half_angle, M_PI - angle, tip + Point(gap, 0)));
+            }
+        return out;
+    };
+    auto check = [delta](const Polygons &subject, ClipperLib::JoinType joinType) {
+        Polygons reference = union_(expand(subject, delta, joinType));
+        Polygons result    = expand_parallel(subject, delta, joinType);
+        REQUIRE(reference.size() == subject.size() / 2);
+        REQUIRE(result.size() == reference.size());
+        REQUIRE(area(result) == Approx(area(reference)));
+        // The output polygons do not overlap.
+        REQUIRE(area(union_(result)) == Approx(area(result)));
+    };
+
+    SECTION("square joins of diagonal tips") {
+        // A square join reaches delta * sqrt(2) from a sharp corner along the axes.
+        check(pairs(M_PI / 18., M_PI / 4., coord_t(2.1 * delta)), ClipperLib::jtSquare);
+    }
+    SECTION("miter joins") {
+        // A miter join of a 40 degree corner reaches 2.9 * delta from the tip.
+        check(pairs(M_PI / 9., 0., coord_t(4. * delta)), ClipperLib::jtMiter);
+    }
+}